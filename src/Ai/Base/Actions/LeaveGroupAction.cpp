@@ -20,7 +20,7 @@ bool LeaveGroupAction::Execute(Event event)
 
 bool PartyCommandAction::Execute(Event event)
 {
-    WorldPacket& p = event.getPacket();
+    WorldPacket p(event.getPacket());
     p.rpos(0);
     uint32 operation;
     std::string member;
@@ -49,7 +49,7 @@ bool PartyCommandAction::Execute(Event event)
 
 bool UninviteAction::Execute(Event event)
 {
-    WorldPacket& p = event.getPacket();
+    WorldPacket p(event.getPacket());
     if (p.GetOpcode() == CMSG_GROUP_UNINVITE)
     {
         p.rpos(0);
@@ -17,7 +17,7 @@ bool TaxiAction::Execute(Event event)
 
     LastMovement& movement = context->GetValue<LastMovement&>("last taxi")->Get();
 
-    WorldPacket& p = event.getPacket();
+    WorldPacket const& p = event.getPacket();
     std::string const param = event.getParam();
     if ((!p.empty() && (p.GetOpcode() == CMSG_TAXICLEARALLNODES || p.GetOpcode() == CMSG_TAXICLEARNODE)) ||
         param == "clear")
@@ -161,7 +161,7 @@ bool BuffTrigger::IsActive()
         return false;
     if (!SpellTrigger::IsActive())
         return false;
-    Aura* aura = botAI->GetAura(spell, target, checkIsOwner, checkDuration);
+    Aura* aura = botAI->GetAura(auraNameId, target, checkIsOwner, checkDuration);
     if (!aura)
         return true;
     if (beforeDuration && aura->GetDuration() < beforeDuration)
@@ -462,7 +462,7 @@ bool DeflectSpellTrigger::IsActive()
 
 bool AttackerCountTrigger::IsActive() { return AI_VALUE(uint8, "attacker count") >= amount; }
 
-bool HasAuraTrigger::IsActive() { return botAI->HasAura(getName(), GetTarget(), false, false, -1, true); }
+bool HasAuraTrigger::IsActive() { return botAI->HasAura(auraNameId, GetTarget(), false, false, -1, true); }
 
 bool LossOfControlTrigger::IsActive()
 {
@@ -490,7 +490,7 @@ bool FearSleepSapTrigger::IsActive()
 
 bool HasAuraStackTrigger::IsActive()
 {
-    Aura* aura = botAI->GetAura(getName(), GetTarget(), false, true, stack);
+    Aura* aura = botAI->GetAura(auraNameId, GetTarget(), false, true, stack);
     // sLog->outMessage("playerbot", LOG_LEVEL_DEBUG, "HasAuraStackTrigger::IsActive %s %d", getName(), aura ?
     // aura->GetStackAmount() : -1);
     return aura;
@@ -520,7 +520,7 @@ bool TimerBGTrigger::IsActive()
     return false;
 }
 
-bool HasNoAuraTrigger::IsActive() { return !botAI->HasAura(getName(), GetTarget()); }
+bool HasNoAuraTrigger::IsActive() { return !botAI->HasAura(auraNameId, GetTarget()); }
 
 bool TankAssistTrigger::IsActive()
 {
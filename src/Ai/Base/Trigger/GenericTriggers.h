@@ -9,6 +9,7 @@
 #include <utility>
 
 #include "HealthTriggers.h"
+#include "PlayerbotSpellRepository.h"
 #include "RangeTriggers.h"
 #include "Trigger.h"
 #include "Player.h"
@@ -318,7 +319,8 @@ class BuffTrigger : public SpellTrigger
 {
 public:
     BuffTrigger(PlayerbotAI* botAI, std::string const spell, int32 checkInterval = 1, bool checkIsOwner = false, bool checkDuration = false, uint32 beforeDuration = 0)
-        : SpellTrigger(botAI, spell, checkInterval)
+        : SpellTrigger(botAI, spell, checkInterval),
+          auraNameId(PlayerbotSpellRepository::Instance().GetAuraNameId(spell))
     {
         this->checkIsOwner = checkIsOwner;
         this->checkDuration = checkDuration;
@@ -330,6 +332,7 @@ public:
     bool IsActive() override;
 
 protected:
+    AuraNameId auraNameId;
     bool checkIsOwner;
     bool checkDuration;
     uint32 beforeDuration;
@@ -612,19 +615,24 @@ class HasAuraTrigger : public Trigger
 {
 public:
     HasAuraTrigger(PlayerbotAI* botAI, std::string const spell, int32 checkInterval = 1)
-        : Trigger(botAI, spell, checkInterval)
+        : Trigger(botAI, spell, checkInterval), auraNameId(PlayerbotSpellRepository::Instance().GetAuraNameId(spell))
     {
     }
 
     std::string const GetTargetName() override { return "self target"; }
     bool IsActive() override;
+
+protected:
+    AuraNameId auraNameId;
 };
 
 class HasAuraStackTrigger : public Trigger
 {
 public:
     HasAuraStackTrigger(PlayerbotAI* ai, std::string spell, int stack, int checkInterval = 1)
-        : Trigger(ai, spell, checkInterval), stack(stack)
+        : Trigger(ai, spell, checkInterval),
+          auraNameId(PlayerbotSpellRepository::Instance().GetAuraNameId(spell)),
+          stack(stack)
     {
     }
 
@@ -632,16 +640,23 @@ public:
     bool IsActive() override;
 
 private:
+    AuraNameId auraNameId;
     int stack;
 };
 
 class HasNoAuraTrigger : public Trigger
 {
 public:
-    HasNoAuraTrigger(PlayerbotAI* botAI, std::string const spell) : Trigger(botAI, spell) {}
+    HasNoAuraTrigger(PlayerbotAI* botAI, std::string const spell)
+        : Trigger(botAI, spell), auraNameId(PlayerbotSpellRepository::Instance().GetAuraNameId(spell))
+    {
+    }
 
     std::string const GetTargetName() override { return "self target"; }
     bool IsActive() override;
+
+protected:
+    AuraNameId auraNameId;
 };
 
 class TimerTrigger : public Trigger
@@ -9,8 +9,7 @@
 
 void WorldPacketTrigger::ExternalEvent(WorldPacket& revData, Player* eventOwner)
 {
-    packet = revData;
-    owner = eventOwner;
+    event = Event(getName(), revData, eventOwner);
     triggered = true;
 }
 
@@ -19,7 +18,7 @@ Event WorldPacketTrigger::Check()
     if (!triggered)
         return Event();
 
-    return Event(getName(), packet, owner);
+    return event;
 }
 
 void WorldPacketTrigger::Reset() { triggered = false; }
@@ -8,7 +8,6 @@
 
 #include "Trigger.h"
 
-class Event;
 class Player;
 class PlayerbotAI;
 class WorldPacket;
@@ -21,11 +20,11 @@ public:
     void ExternalEvent(WorldPacket& packet, Player* owner = nullptr) override;
     Event Check() override;
     void Reset() override;
+    bool IsEventDriven() override { return true; }
 
 private:
-    WorldPacket packet;
+    Event event;
     bool triggered;
-    Player* owner;
 };
 
 #endif
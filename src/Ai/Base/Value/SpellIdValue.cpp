@@ -13,40 +13,45 @@ SpellIdValue::SpellIdValue(PlayerbotAI* botAI) : CalculatedValue<uint32>(botAI,
 
 VehicleSpellIdValue::VehicleSpellIdValue(PlayerbotAI* botAI) : CalculatedValue<uint32>(botAI, "vehicle spell id") {}
 
-uint32 SpellIdValue::Calculate()
+std::set<uint32> SpellIdValue::FindKnownSpells()
 {
-    std::string namepart = qualifier;
-    ItemIds itemIds = ChatHelper::parseItems(namepart);
+    PlayerbotSpellRepository& spellRepository = PlayerbotSpellRepository::Instance();
+    std::vector<uint32> const& namedSpells = spellRepository.GetSpellsWithName(nameId);
+    PlayerSpellMap const& spellMap = bot->GetSpellMap();
 
-    PlayerbotChatHandler handler(bot);
-    uint32 extractedSpellId = handler.extractSpellId(namepart);
-    if (extractedSpellId)
-        if (SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(extractedSpellId))
-            namepart = spellInfo->SpellName[0];
-
-    std::wstring wnamepart;
-    if (!Utf8toWStr(namepart, wnamepart))
-        return 0;
+    auto isCastable = [](PlayerSpell const* playerSpell, SpellInfo const* spellInfo)
+    {
+        if (playerSpell->State == PLAYERSPELL_REMOVED || !playerSpell->Active)
+            return false;
 
-    wstrToLower(wnamepart);
-    char firstSymbol = tolower(namepart[0]);
-    int spellLength = wnamepart.length();
+        if (!spellInfo || spellInfo->IsPassive())
+            return false;
 
-    LocaleConstant loc = LOCALE_enUS;
+        return spellInfo->Effects[0].Effect != SPELL_EFFECT_LEARN_SPELL;
+    };
 
     std::set<uint32> spellIds;
-    for (PlayerSpellMap::iterator itr = bot->GetSpellMap().begin(); itr != bot->GetSpellMap().end(); ++itr)
+
+    // Look up the (usually short) rank chain in the spellbook unless the spellbook is smaller or
+    // linked items need a scan for spells creating them
+    if (itemIds.empty() && namedSpells.size() < spellMap.size())
     {
-        uint32 spellId = itr->first;
+        for (uint32 spellId : namedSpells)
+        {
+            PlayerSpellMap::const_iterator itr = spellMap.find(spellId);
+            if (itr != spellMap.end() && isCastable(itr->second, sSpellMgr->GetSpellInfo(spellId)))
+                spellIds.insert(spellId);
+        }
 
-        if (itr->second->State == PLAYERSPELL_REMOVED || !itr->second->Active)
-            continue;
+        return spellIds;
+    }
 
-        SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(spellId);
-        if (!spellInfo || spellInfo->IsPassive())
-            continue;
+    for (PlayerSpellMap::const_iterator itr = spellMap.begin(); itr != spellMap.end(); ++itr)
+    {
+        uint32 spellId = itr->first;
 
-        if (spellInfo->Effects[0].Effect == SPELL_EFFECT_LEARN_SPELL)
+        SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(spellId);
+        if (!isCastable(itr->second, spellInfo))
             continue;
 
         bool useByItem = false;
@@ -60,17 +65,55 @@ uint32 SpellIdValue::Calculate()
             }
         }
 
-        char const* spellName = spellInfo->SpellName[loc];
-        if (!useByItem && (tolower(spellName[0]) != firstSymbol || strlen(spellName) != spellLength ||
-                           !Utf8FitTo(spellName, wnamepart)))
+        if (!useByItem && (!nameId || spellRepository.GetSpellAuraNameId(spellId) != nameId))
             continue;
 
         spellIds.insert(spellId);
     }
 
+    return spellIds;
+}
+
+uint32 SpellIdValue::Calculate()
+{
+    if (resolvedQualifier != qualifier || !knownSpellbookVersion)
+    {
+        std::string namepart = qualifier;
+        itemIds = ChatHelper::parseItems(namepart);
+
+        PlayerbotChatHandler handler(bot);
+        uint32 extractedSpellId = handler.extractSpellId(namepart);
+        if (extractedSpellId)
+            if (SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(extractedSpellId))
+                namepart = spellInfo->SpellName[0];
+
+        nameId = PlayerbotSpellRepository::Instance().GetAuraNameId(namepart);
+        resolvedQualifier = qualifier;
+        knownSpellbookVersion = 0;
+    }
+
+    if (!nameId && itemIds.empty())
+        return 0;
+
+    // The learn/forget hooks do not see every spellbook change (e.g. talent swaps), so the spell
+    // count and active spec are part of the cache key as well
+    uint32 spellbookVersion = botAI->GetSpellbookVersion();
+    size_t spellCount = bot->GetSpellMap().size();
+    uint8 spec = bot->GetActiveSpec();
+    if (knownSpellbookVersion != spellbookVersion || knownSpellCount != spellCount || knownSpec != spec)
+    {
+        knownSpellIds = FindKnownSpells();
+        knownSpellbookVersion = spellbookVersion;
+        knownSpellCount = spellCount;
+        knownSpec = spec;
+    }
+
+    std::set<uint32> spellIds = knownSpellIds;
+
     Pet* pet = bot->GetPet();
-    if (spellIds.empty() && pet)
+    if (spellIds.empty() && pet && nameId)
     {
+        PlayerbotSpellRepository& spellRepository = PlayerbotSpellRepository::Instance();
         for (PetSpellMap::const_iterator itr = pet->m_spells.begin(); itr != pet->m_spells.end(); ++itr)
         {
             if (itr->second.state == PETSPELL_REMOVED)
@@ -84,9 +127,7 @@ uint32 SpellIdValue::Calculate()
             if (spellInfo->Effects[0].Effect == SPELL_EFFECT_LEARN_SPELL)
                 continue;
 
-            char const* spellName = spellInfo->SpellName[loc];
-            if (tolower(spellName[0]) != firstSymbol || strlen(spellName) != spellLength ||
-                !Utf8FitTo(spellName, wnamepart))
+            if (spellRepository.GetSpellAuraNameId(spellId) != nameId)
                 continue;
 
             spellIds.insert(spellId);
@@ -6,7 +6,11 @@
 #ifndef _PLAYERBOT_SPELLIDVALUE_H
 #define _PLAYERBOT_SPELLIDVALUE_H
 
+#include <set>
+#include <string>
+
 #include "NamedObjectContext.h"
+#include "PlayerbotSpellRepository.h"
 #include "Value.h"
 
 class PlayerbotAI;
@@ -17,6 +21,23 @@ public:
     SpellIdValue(PlayerbotAI* botAI);
 
     uint32 Calculate() override;
+
+private:
+    /**
+     * @brief Active, castable spellbook spells matching the resolved name (or creating one of the linked items)
+     */
+    std::set<uint32> FindKnownSpells();
+
+    // Parsed from the qualifier once
+    std::string resolvedQualifier;
+    AuraNameId nameId;
+    std::set<uint32> itemIds;
+
+    // Known spells, recalculated only when the spellbook changes
+    std::set<uint32> knownSpellIds;
+    uint32 knownSpellbookVersion = 0;
+    size_t knownSpellCount = 0;
+    uint8 knownSpec = 0;
 };
 
 class VehicleSpellIdValue : public CalculatedValue<uint32>, public Qualified
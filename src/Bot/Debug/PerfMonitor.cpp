@@ -5,51 +5,310 @@
 
 #include "PerfMonitor.h"
 
+#include <bit>
+
 #include "Playerbots.h"
 
+namespace
+{
+    constexpr uint32 PerfMonSubBuckets = 1 << PERF_MON_SUB_BUCKET_BITS;
+
+    uint64 MetricId(PerformanceMetric metric, std::string_view name, uint64 parent)
+    {
+        uint64 hash = 14695981039346656037ULL;
+        auto mix = [&hash](uint64 byte)
+        {
+            hash ^= byte & 0xFF;
+            hash *= 1099511628211ULL;
+        };
+
+        mix(metric);
+        for (uint32 i = 0; i < 8; ++i)
+            mix(parent >> (i * 8));
+
+        for (char c : name)
+            mix(static_cast<uint8>(c));
+
+        return hash ? hash : 1;
+    }
+
+    uint32 BucketIndex(uint64 elapsed)
+    {
+        if (elapsed < PerfMonSubBuckets)
+            return elapsed;
+
+        uint32 exponent = std::bit_width(elapsed) - 1;
+        uint32 index = PerfMonSubBuckets + (exponent - PERF_MON_SUB_BUCKET_BITS) * PerfMonSubBuckets +
+                       ((elapsed >> (exponent - PERF_MON_SUB_BUCKET_BITS)) & (PerfMonSubBuckets - 1));
+
+        return std::min<uint32>(index, PERF_MON_BUCKETS - 1);
+    }
+
+    // Midpoint of the bucket range, in microseconds
+    uint64 BucketValue(uint32 index)
+    {
+        if (index < PerfMonSubBuckets)
+            return index;
+
+        uint32 exponent = (index - PerfMonSubBuckets) / PerfMonSubBuckets + PERF_MON_SUB_BUCKET_BITS;
+        uint64 subBucket = (index - PerfMonSubBuckets) % PerfMonSubBuckets;
+        uint64 width = uint64(1) << (exponent - PERF_MON_SUB_BUCKET_BITS);
+
+        return (PerfMonSubBuckets + subBucket) * width + width / 2;
+    }
+
+    uint64 ElapsedSince(std::chrono::steady_clock::time_point started)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started)
+            .count();
+    }
+
+    std::string const MetricKey(PerformanceMetric metric)
+    {
+        switch (metric)
+        {
+            case PERF_MON_TRIGGER:
+                return "Trigger";
+            case PERF_MON_VALUE:
+                return "Value";
+            case PERF_MON_ACTION:
+                return "Action";
+            case PERF_MON_RNDBOT:
+                return "RndBot";
+            case PERF_MON_TOTAL:
+                return "Total";
+            default:
+                return "?";
+        }
+    }
+}
+
+void PerformanceHistogram::Record(uint64_t elapsed)
+{
+    totalTime.store(totalTime.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+    if (maxTime.load(std::memory_order_relaxed) < elapsed)
+        maxTime.store(elapsed, std::memory_order_relaxed);
+
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    std::atomic<uint32_t>& bucket = buckets[BucketIndex(elapsed)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void PerformanceHistogram::Clear()
+{
+    totalTime.store(0, std::memory_order_relaxed);
+    maxTime.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint32_t>& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+uint64_t PerformanceData::Percentile(float fraction) const
+{
+    uint64 total = 0;
+    for (uint64 bucket : buckets)
+        total += bucket;
+
+    if (!total)
+        return 0;
+
+    uint64 rank = std::max<uint64>(1, uint64(fraction * total + 0.5f));
+    uint64 seen = 0;
+    for (uint32 i = 0; i < PERF_MON_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::min(BucketValue(i), maxTime);
+    }
+
+    return maxTime;
+}
+
+PerfMonitor::Shard& PerfMonitor::GetShard()
+{
+    thread_local std::shared_ptr<Shard> shard;
+    if (!shard)
+    {
+        shard = std::make_shared<Shard>();
+
+        std::lock_guard<std::mutex> guard(lock);
+        shards.push_back(shard);
+    }
+
+    return *shard;
+}
+
+PerformanceHistogram* PerfMonitor::Resolve(PerformanceMetric metric, std::string_view name, uint64_t parent,
+                                           uint64_t& id)
+{
+    id = MetricId(metric, name, parent);
+
+    Shard& shard = GetShard();
+
+    // Only the owning thread inserts, so an unlocked lookup is safe here
+    auto found = shard.data.find(id);
+    if (found != shard.data.end())
+        return found->second.get();
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        names.try_emplace(id, MetricName{metric, std::string(name), parent});
+    }
+
+    std::unique_ptr<PerformanceHistogram> histogram = std::make_unique<PerformanceHistogram>();
+    PerformanceHistogram* result = histogram.get();
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.data.emplace(id, std::move(histogram));
+
+    return result;
+}
+
+void PerfMonitor::RecordCacheAccess(std::string_view name, bool hit)
+{
+    uint64 id = MetricId(PERF_MON_VALUE, name, 0);
+
+    Shard& shard = GetShard();
+
+    PerformanceCacheCounter* counter = nullptr;
+    auto found = shard.cache.find(id);
+    if (found != shard.cache.end())
+    {
+        counter = found->second.get();
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            names.try_emplace(id, MetricName{PERF_MON_VALUE, std::string(name), 0});
+        }
+
+        std::unique_ptr<PerformanceCacheCounter> created = std::make_unique<PerformanceCacheCounter>();
+        counter = created.get();
+
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.cache.emplace(id, std::move(created));
+    }
+
+    std::atomic<uint64_t>& target = hit ? counter->hits : counter->misses;
+    target.store(target.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void PerfMonitor::RecordCount(std::string_view name, uint64_t value)
+{
+    uint64 id = MetricId(PERF_MON_TOTAL, name, 0);
+
+    Shard& shard = GetShard();
+
+    PerformanceCount* count = nullptr;
+    auto found = shard.counts.find(id);
+    if (found != shard.counts.end())
+    {
+        count = found->second.get();
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            names.try_emplace(id, MetricName{PERF_MON_TOTAL, std::string(name), 0});
+        }
+
+        std::unique_ptr<PerformanceCount> created = std::make_unique<PerformanceCount>();
+        count = created.get();
+
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.counts.emplace(id, std::move(created));
+    }
+
+    count->total.store(count->total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    if (count->maxValue.load(std::memory_order_relaxed) < value)
+        count->maxValue.store(value, std::memory_order_relaxed);
+
+    count->samples.store(count->samples.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
 PerfMonitorOperation* PerfMonitor::start(PerformanceMetric metric, std::string const name,
                                                        PerformanceStack* stack)
 {
     if (!sPlayerbotAIConfig.perfMonEnabled)
         return nullptr;
 
-    std::string stackName = name;
+    uint64 parent = stack && !stack->empty() ? stack->back() : 0;
+    uint64 id = 0;
+    PerformanceHistogram* data = Resolve(metric, name, parent, id);
 
     if (stack)
-    {
-        if (!stack->empty())
-        {
-            std::ostringstream out;
-            out << stackName << " [";
+        stack->push_back(id);
 
-            for (std::vector<std::string>::reverse_iterator i = stack->rbegin(); i != stack->rend(); ++i)
-                out << *i << (std::next(i) == stack->rend() ? "" : "|");
+    return new PerfMonitorOperation(data, stack, id);
+}
 
-            out << "]";
+std::string const PerfMonitor::FormatName(uint64_t id, bool fullStack)
+{
+    auto found = names.find(id);
+    if (found == names.end())
+        return "?";
 
-            stackName = out.str().c_str();
-        }
+    std::string result = found->second.name;
+
+    uint64 parent = found->second.parent;
+    bool first = true;
+    while (parent)
+    {
+        auto parentName = names.find(parent);
+        if (parentName == names.end())
+            break;
+
+        result += first ? " [" : "|";
+        result += parentName->second.name;
+        first = false;
+
+        if (!fullStack)
+            break;
 
-        stack->push_back(name);
+        parent = parentName->second.parent;
     }
 
+    if (!first)
+        result += "]";
+
+    return result;
+}
+
+std::map<PerformanceMetric, std::map<std::string, PerformanceData>> PerfMonitor::Merge(bool fullStack)
+{
+    std::map<PerformanceMetric, std::map<std::string, PerformanceData>> result;
+
     std::lock_guard<std::mutex> guard(lock);
-    PerformanceData* pd = data[metric][stackName];
-    if (!pd)
+    for (std::shared_ptr<Shard> const& shard : shards)
     {
-        pd = new PerformanceData();
-        pd->minTime = 0;
-        pd->maxTime = 0;
-        pd->totalTime = 0;
-        pd->count = 0;
-        data[metric][stackName] = pd;
+        std::lock_guard<std::mutex> shardGuard(shard->lock);
+        for (auto const& [id, histogram] : shard->data)
+        {
+            uint32 count = histogram->count.load(std::memory_order_relaxed);
+            if (!count)
+                continue;
+
+            auto name = names.find(id);
+            if (name == names.end())
+                continue;
+
+            PerformanceData& pd = result[name->second.metric][FormatName(id, fullStack)];
+            pd.totalTime += histogram->totalTime.load(std::memory_order_relaxed);
+            pd.maxTime = std::max<uint64>(pd.maxTime, histogram->maxTime.load(std::memory_order_relaxed));
+            pd.count += count;
+            for (uint32 i = 0; i < PERF_MON_BUCKETS; ++i)
+                pd.buckets[i] += histogram->buckets[i].load(std::memory_order_relaxed);
+        }
     }
 
-    return new PerfMonitorOperation(pd, name, stack);
+    return result;
 }
 
 void PerfMonitor::PrintStats(bool perTick, bool fullStack)
 {
+    std::map<PerformanceMetric, std::map<std::string, PerformanceData>> data = Merge(fullStack);
     if (data.empty())
         return;
 
@@ -58,48 +317,25 @@ void PerfMonitor::PrintStats(bool perTick, bool fullStack)
         float updateAITotalTime = 0;
         for (auto& map : data[PERF_MON_TOTAL])
             if (map.first.find("PlayerbotAI::UpdateAIInternal") != std::string::npos)
-                updateAITotalTime += map.second->totalTime;
+                updateAITotalTime += map.second.totalTime;
 
         LOG_INFO(
             "playerbots",
             "--------------------------------------[TOTAL BOT]------------------------------------------------------");
         LOG_INFO("playerbots",
-                 "percentage     time  |     min ..     max (      avg  of      count) - type      : name");
+                 "percentage     time  |     p50 ..     p99 ..    p999 (      avg  of      count) - type      : name");
         LOG_INFO(
             "playerbots",
             "-------------------------------------------------------------------------------------------------------");
 
-        for (std::map<PerformanceMetric, std::map<std::string, PerformanceData*>>::iterator i = data.begin();
-             i != data.end(); ++i)
+        for (auto i = data.begin(); i != data.end(); ++i)
         {
-            std::map<std::string, PerformanceData*> pdMap = i->second;
-
-            std::string key;
-            switch (i->first)
-            {
-                case PERF_MON_TRIGGER:
-                    key = "Trigger";
-                    break;
-                case PERF_MON_VALUE:
-                    key = "Value";
-                    break;
-                case PERF_MON_ACTION:
-                    key = "Action";
-                    break;
-                case PERF_MON_RNDBOT:
-                    key = "RndBot";
-                    break;
-                case PERF_MON_TOTAL:
-                    key = "Total";
-                    break;
-                default:
-                    key = "?";
-                    break;
-            }
+            std::map<std::string, PerformanceData> const& pdMap = i->second;
+            std::string const key = MetricKey(i->first);
 
             std::vector<std::string> names;
 
-            for (std::map<std::string, PerformanceData*>::iterator j = pdMap.begin(); j != pdMap.end(); ++j)
+            for (auto j = pdMap.begin(); j != pdMap.end(); ++j)
             {
                 if (key == "Total" && j->first.find("PlayerbotAI::UpdateAIInternal") == std::string::npos)
                     continue;
@@ -108,196 +344,284 @@ void PerfMonitor::PrintStats(bool perTick, bool fullStack)
             }
 
             std::sort(names.begin(), names.end(),
-                      [pdMap](std::string const i, std::string const j)
-                      { return pdMap.at(i)->totalTime < pdMap.at(j)->totalTime; });
+                      [&pdMap](std::string const& i, std::string const& j)
+                      { return pdMap.at(i).totalTime < pdMap.at(j).totalTime; });
 
-            uint64 typeTotalTime = 0;
-            uint64 typeMinTime = 0xffffffffu;
-            uint64 typeMaxTime = 0;
-            uint32 typeCount = 0;
+            PerformanceData typeData;
             for (auto& name : names)
             {
-                PerformanceData* pd = pdMap[name];
-                typeTotalTime += pd->totalTime;
-                typeCount += pd->count;
-                if (typeMinTime > pd->minTime)
-                    typeMinTime = pd->minTime;
-                if (typeMaxTime < pd->maxTime)
-                    typeMaxTime = pd->maxTime;
-                float perc = (float)pd->totalTime / updateAITotalTime * 100.0f;
-                float time = (float)pd->totalTime / 1000000.0f;
-                float minTime = (float)pd->minTime / 1000.0f;
-                float maxTime = (float)pd->maxTime / 1000.0f;
-                float avg = (float)pd->totalTime / (float)pd->count / 1000.0f;
-                std::string disName = name;
-                if (!fullStack && disName.find("|") != std::string::npos)
-                    disName = disName.substr(0, disName.find("|")) + "]";
-
-                if (perc >= 0.1f || avg >= 0.25f || pd->maxTime > 1000)
+                PerformanceData const& pd = pdMap.at(name);
+                typeData.totalTime += pd.totalTime;
+                typeData.count += pd.count;
+                typeData.maxTime = std::max(typeData.maxTime, pd.maxTime);
+                for (uint32 b = 0; b < PERF_MON_BUCKETS; ++b)
+                    typeData.buckets[b] += pd.buckets[b];
+
+                float perc = (float)pd.totalTime / updateAITotalTime * 100.0f;
+                float time = (float)pd.totalTime / 1000000.0f;
+                float p50 = (float)pd.Percentile(0.5f) / 1000.0f;
+                float p99 = (float)pd.Percentile(0.99f) / 1000.0f;
+                float p999 = (float)pd.Percentile(0.999f) / 1000.0f;
+                float avg = (float)pd.totalTime / (float)pd.count / 1000.0f;
+
+                if (perc >= 0.1f || avg >= 0.25f || pd.maxTime > 1000)
                 {
                     LOG_INFO("playerbots",
-                             "{:7.3f}% {:10.3f}s | {:7.1f} .. {:7.1f} ({:10.3f} of {:10d}) - {:6}    : {}", perc, time,
-                             minTime, maxTime, avg, pd->count, key.c_str(), disName.c_str());
+                             "{:7.3f}% {:10.3f}s | {:7.1f} .. {:7.1f} .. {:7.1f} ({:10.3f} of {:10d}) - {:6}    : {}",
+                             perc, time, p50, p99, p999, avg, pd.count, key.c_str(), name.c_str());
                 }
             }
-            float tPerc = (float)typeTotalTime / (float)updateAITotalTime * 100.0f;
-            float tTime = (float)typeTotalTime / 1000000.0f;
-            float tMinTime = (float)typeMinTime / 1000.0f;
-            float tMaxTime = (float)typeMaxTime / 1000.0f;
-            float tAvg = (float)typeTotalTime / (float)typeCount / 1000.0f;
-            LOG_INFO("playerbots", "{:7.3f}% {:10.3f}s | {:7.1f} .. {:7.1f} ({:10.3f} of {:10d}) - {:6}    : {}", tPerc,
-                     tTime, tMinTime, tMaxTime, tAvg, typeCount, key.c_str(), "Total");
+            float tPerc = (float)typeData.totalTime / (float)updateAITotalTime * 100.0f;
+            float tTime = (float)typeData.totalTime / 1000000.0f;
+            float tP50 = (float)typeData.Percentile(0.5f) / 1000.0f;
+            float tP99 = (float)typeData.Percentile(0.99f) / 1000.0f;
+            float tP999 = (float)typeData.Percentile(0.999f) / 1000.0f;
+            float tAvg = (float)typeData.totalTime / (float)typeData.count / 1000.0f;
+            LOG_INFO("playerbots",
+                     "{:7.3f}% {:10.3f}s | {:7.1f} .. {:7.1f} .. {:7.1f} ({:10.3f} of {:10d}) - {:6}    : {}", tPerc,
+                     tTime, tP50, tP99, tP999, tAvg, typeData.count, key.c_str(), "Total");
             LOG_INFO("playerbots", " ");
         }
     }
     else
     {
-        float fullTickCount = data[PERF_MON_TOTAL]["PlayerbotAIBase::FullTick"]->count;
-        float fullTickTotalTime = data[PERF_MON_TOTAL]["PlayerbotAIBase::FullTick"]->totalTime;
+        auto fullTick = data[PERF_MON_TOTAL].find("PlayerbotAIBase::FullTick");
+        if (fullTick == data[PERF_MON_TOTAL].end())
+            return;
+
+        float fullTickCount = fullTick->second.count;
+        float fullTickTotalTime = fullTick->second.totalTime;
 
         LOG_INFO(
             "playerbots",
             "---------------------------------------[PER TICK]------------------------------------------------------");
         LOG_INFO("playerbots",
-                 "percentage     time  |     min ..     max (      avg  of      count) - type      : name");
+                 "percentage     time  |     p50 ..     p99 ..    p999 (      avg  of      count) - type      : name");
         LOG_INFO(
             "playerbots",
             "-------------------------------------------------------------------------------------------------------");
 
-        for (std::map<PerformanceMetric, std::map<std::string, PerformanceData*>>::iterator i = data.begin();
-             i != data.end(); ++i)
+        for (auto i = data.begin(); i != data.end(); ++i)
         {
-            std::map<std::string, PerformanceData*> pdMap = i->second;
-
-            std::string key;
-            switch (i->first)
-            {
-                case PERF_MON_TRIGGER:
-                    key = "Trigger";
-                    break;
-                case PERF_MON_VALUE:
-                    key = "Value";
-                    break;
-                case PERF_MON_ACTION:
-                    key = "Action";
-                    break;
-                case PERF_MON_RNDBOT:
-                    key = "RndBot";
-                    break;
-                case PERF_MON_TOTAL:
-                    key = "Total";
-                    break;
-                default:
-                    key = "?";
-            }
+            std::map<std::string, PerformanceData> const& pdMap = i->second;
+            std::string const key = MetricKey(i->first);
 
             std::vector<std::string> names;
 
-            for (std::map<std::string, PerformanceData*>::iterator j = pdMap.begin(); j != pdMap.end(); ++j)
+            for (auto j = pdMap.begin(); j != pdMap.end(); ++j)
             {
                 names.push_back(j->first);
             }
 
             std::sort(names.begin(), names.end(),
-                      [pdMap](std::string const i, std::string const j)
-                      { return pdMap.at(i)->totalTime < pdMap.at(j)->totalTime; });
+                      [&pdMap](std::string const& i, std::string const& j)
+                      { return pdMap.at(i).totalTime < pdMap.at(j).totalTime; });
 
-            uint64 typeTotalTime = 0;
-            uint64 typeMinTime = 0xffffffffu;
-            uint64 typeMaxTime = 0;
-            uint32 typeCount = 0;
+            PerformanceData typeData;
             for (auto& name : names)
             {
-                PerformanceData* pd = pdMap[name];
-                typeTotalTime += pd->totalTime;
-                typeCount += pd->count;
-                if (typeMinTime > pd->minTime)
-                    typeMinTime = pd->minTime;
-                if (typeMaxTime < pd->maxTime)
-                    typeMaxTime = pd->maxTime;
-                float perc = (float)pd->totalTime / fullTickTotalTime * 100.0f;
-                float time = (float)pd->totalTime / fullTickCount / 1000.0f;
-                float minTime = (float)pd->minTime / 1000.0f;
-                float maxTime = (float)pd->maxTime / 1000.0f;
-                float avg = (float)pd->totalTime / (float)pd->count / 1000.0f;
-                float amount = (float)pd->count / fullTickCount;
-                std::string disName = name;
-                if (!fullStack && disName.find("|") != std::string::npos)
-                    disName = disName.substr(0, disName.find("|")) + "]";
-                if (perc >= 0.1f || avg >= 0.25f || pd->maxTime > 1000)
+                PerformanceData const& pd = pdMap.at(name);
+                typeData.totalTime += pd.totalTime;
+                typeData.count += pd.count;
+                typeData.maxTime = std::max(typeData.maxTime, pd.maxTime);
+                for (uint32 b = 0; b < PERF_MON_BUCKETS; ++b)
+                    typeData.buckets[b] += pd.buckets[b];
+
+                float perc = (float)pd.totalTime / fullTickTotalTime * 100.0f;
+                float time = (float)pd.totalTime / fullTickCount / 1000.0f;
+                float p50 = (float)pd.Percentile(0.5f) / 1000.0f;
+                float p99 = (float)pd.Percentile(0.99f) / 1000.0f;
+                float p999 = (float)pd.Percentile(0.999f) / 1000.0f;
+                float avg = (float)pd.totalTime / (float)pd.count / 1000.0f;
+                float amount = (float)pd.count / fullTickCount;
+                if (perc >= 0.1f || avg >= 0.25f || pd.maxTime > 1000)
                 {
                     LOG_INFO("playerbots",
-                             "{:7.3f}% {:9.3f}ms | {:7.1f} .. {:7.1f} ({:10.3f} of {:10.2f}) - {:6}    : {}", perc,
-                             time, minTime, maxTime, avg, amount, key.c_str(), disName.c_str());
+                             "{:7.3f}% {:9.3f}ms | {:7.1f} .. {:7.1f} .. {:7.1f} ({:10.3f} of {:10.2f}) - {:6}    : {}",
+                             perc, time, p50, p99, p999, avg, amount, key.c_str(), name.c_str());
                 }
             }
             if (i->first != PERF_MON_TOTAL)
             {
-                float tPerc = (float)typeTotalTime / (float)fullTickTotalTime * 100.0f;
-                float tTime = (float)typeTotalTime / fullTickCount / 1000.0f;
-                float tMinTime = (float)typeMinTime / 1000.0f;
-                float tMaxTime = (float)typeMaxTime / 1000.0f;
-                float tAvg = (float)typeTotalTime / (float)typeCount / 1000.0f;
-                float tAmount = (float)typeCount / fullTickCount;
-                LOG_INFO("playerbots", "{:7.3f}% {:9.3f}ms | {:7.1f} .. {:7.1f} ({:10.3f} of {:10.2f}) - {:6}    : {}",
-                         tPerc, tTime, tMinTime, tMaxTime, tAvg, tAmount, key.c_str(), "Total");
+                float tPerc = (float)typeData.totalTime / (float)fullTickTotalTime * 100.0f;
+                float tTime = (float)typeData.totalTime / fullTickCount / 1000.0f;
+                float tP50 = (float)typeData.Percentile(0.5f) / 1000.0f;
+                float tP99 = (float)typeData.Percentile(0.99f) / 1000.0f;
+                float tP999 = (float)typeData.Percentile(0.999f) / 1000.0f;
+                float tAvg = (float)typeData.totalTime / (float)typeData.count / 1000.0f;
+                float tAmount = (float)typeData.count / fullTickCount;
+                LOG_INFO("playerbots",
+                         "{:7.3f}% {:9.3f}ms | {:7.1f} .. {:7.1f} .. {:7.1f} ({:10.3f} of {:10.2f}) - {:6}    : {}",
+                         tPerc, tTime, tP50, tP99, tP999, tAvg, tAmount, key.c_str(), "Total");
             }
             LOG_INFO("playerbots", " ");
         }
     }
+
+    PrintCounts();
+}
+
+void PerfMonitor::PrintCounts()
+{
+    std::map<std::string, PerformanceData> counts;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (std::shared_ptr<Shard> const& shard : shards)
+        {
+            std::lock_guard<std::mutex> shardGuard(shard->lock);
+            for (auto const& [id, count] : shard->counts)
+            {
+                auto name = names.find(id);
+                if (name == names.end())
+                    continue;
+
+                PerformanceData& total = counts[name->second.name];
+                total.totalTime += count->total.load(std::memory_order_relaxed);
+                total.maxTime = std::max<uint64>(total.maxTime, count->maxValue.load(std::memory_order_relaxed));
+                total.count += count->samples.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (counts.empty())
+        return;
+
+    LOG_INFO(
+        "playerbots",
+        "---------------------------------------[COUNTERS]------------------------------------------------------");
+    LOG_INFO("playerbots", "        avg         max       total (   samples) : name");
+    LOG_INFO(
+        "playerbots",
+        "-------------------------------------------------------------------------------------------------------");
+
+    for (auto const& [name, total] : counts)
+    {
+        if (!total.count)
+            continue;
+
+        float avg = (float)total.totalTime / (float)total.count;
+        LOG_INFO("playerbots", "{:11.3f} {:11d} {:11d} ({:10d}) : {}", avg, total.maxTime, total.totalTime, total.count,
+                 name.c_str());
+    }
+
+    LOG_INFO("playerbots", " ");
+}
+
+void PerfMonitor::PrintCacheStats()
+{
+    std::map<std::string, std::pair<uint64, uint64>> counters;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (std::shared_ptr<Shard> const& shard : shards)
+        {
+            std::lock_guard<std::mutex> shardGuard(shard->lock);
+            for (auto const& [id, counter] : shard->cache)
+            {
+                auto name = names.find(id);
+                if (name == names.end())
+                    continue;
+
+                std::pair<uint64, uint64>& total = counters[name->second.name];
+                total.first += counter->hits.load(std::memory_order_relaxed);
+                total.second += counter->misses.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (counters.empty())
+        return;
+
+    std::vector<std::string> valueNames;
+    for (auto const& counter : counters)
+        valueNames.push_back(counter.first);
+
+    std::sort(valueNames.begin(), valueNames.end(),
+              [&counters](std::string const& i, std::string const& j)
+              { return counters.at(i).first > counters.at(j).first; });
+
+    LOG_INFO(
+        "playerbots",
+        "-------------------------------------[VALUE TICK CACHE]------------------------------------------------");
+    LOG_INFO("playerbots", "  hit rate        hits      misses - cached : name");
+    LOG_INFO(
+        "playerbots",
+        "-------------------------------------------------------------------------------------------------------");
+
+    for (std::string const& name : valueNames)
+    {
+        std::pair<uint64, uint64> const& total = counters.at(name);
+        float rate = (float)total.first / (float)(total.first + total.second) * 100.0f;
+        LOG_INFO("playerbots", "{:9.3f}% {:11d} {:11d} - {:6} : {}", rate, total.first, total.second,
+                 sPlayerbotAIConfig.IsTickCachedValue(name) ? "yes" : "no", name.c_str());
+    }
 }
 
 void PerfMonitor::Reset()
 {
-    for (std::map<PerformanceMetric, std::map<std::string, PerformanceData*>>::iterator i = data.begin();
-         i != data.end(); ++i)
+    std::lock_guard<std::mutex> guard(lock);
+    for (std::shared_ptr<Shard> const& shard : shards)
     {
-        std::map<std::string, PerformanceData*> pdMap = i->second;
-        for (std::map<std::string, PerformanceData*>::iterator j = pdMap.begin(); j != pdMap.end(); ++j)
+        std::lock_guard<std::mutex> shardGuard(shard->lock);
+        for (auto const& [id, histogram] : shard->data)
+            histogram->Clear();
+
+        for (auto const& [id, counter] : shard->cache)
+        {
+            counter->hits.store(0, std::memory_order_relaxed);
+            counter->misses.store(0, std::memory_order_relaxed);
+        }
+
+        for (auto const& [id, count] : shard->counts)
         {
-            PerformanceData* pd = j->second;
-            std::lock_guard<std::mutex> guard(pd->lock);
-            pd->minTime = 0;
-            pd->maxTime = 0;
-            pd->totalTime = 0;
-            pd->count = 0;
+            count->total.store(0, std::memory_order_relaxed);
+            count->maxValue.store(0, std::memory_order_relaxed);
+            count->samples.store(0, std::memory_order_relaxed);
         }
     }
 }
 
-PerfMonitorOperation::PerfMonitorOperation(PerformanceData* data, std::string const name,
-                                                         PerformanceStack* stack)
-    : data(data), name(name), stack(stack)
+PerfMonitorOperation::PerfMonitorOperation(PerformanceHistogram* data, PerformanceStack* stack, uint64_t id)
+    : data(data), stack(stack), id(id), started(std::chrono::steady_clock::now())
 {
-    started = (std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()))
-                  .time_since_epoch();
 }
 
 void PerfMonitorOperation::finish()
 {
-    std::chrono::microseconds finished =
-        (std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()))
-            .time_since_epoch();
-    uint64 elapsed = (finished - started).count();
+    data->Record(ElapsedSince(started));
 
-    std::lock_guard<std::mutex> guard(data->lock);
-    if (elapsed > 0)
+    if (stack)
     {
-        if (!data->minTime || data->minTime > elapsed)
-            data->minTime = elapsed;
+        stack->erase(std::remove(stack->begin(), stack->end(), id), stack->end());
+    }
 
-        if (!data->maxTime || data->maxTime < elapsed)
-            data->maxTime = elapsed;
+    delete this;
+}
 
-        data->totalTime += elapsed;
-    }
+PerfMonitorScope::PerfMonitorScope(PerformanceMetric metric, std::string_view name, PerformanceStack* stack)
+{
+    if (!sPlayerbotAIConfig.perfMonEnabled)
+        return;
 
-    ++data->count;
+    uint64 parent = stack && !stack->empty() ? stack->back() : 0;
+    uint64 id = 0;
+    data = sPerfMonitor.Resolve(metric, name, parent, id);
 
     if (stack)
     {
-        stack->erase(std::remove(stack->begin(), stack->end(), name), stack->end());
+        stack->push_back(id);
+        this->stack = stack;
     }
 
-    delete this;
+    started = std::chrono::steady_clock::now();
+}
+
+PerfMonitorScope::~PerfMonitorScope()
+{
+    if (!data)
+        return;
+
+    data->Record(ElapsedSince(started));
+
+    if (stack)
+        stack->pop_back();
 }
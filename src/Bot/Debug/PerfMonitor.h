@@ -6,23 +6,21 @@
 #ifndef _PLAYERBOT_PERFORMANCEMONITOR_H
 #define _PLAYERBOT_PERFORMANCEMONITOR_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <cstdint>
 
-typedef std::vector<std::string> PerformanceStack;
-
-struct PerformanceData
-{
-    uint64_t minTime;
-    uint64_t maxTime;
-    uint64_t totalTime;
-    uint32_t count;
-    std::mutex lock;
-};
+// Ids of the currently open scopes, innermost last
+typedef std::vector<uint64_t> PerformanceStack;
 
 enum PerformanceMetric
 {
@@ -33,17 +31,88 @@ enum PerformanceMetric
     PERF_MON_TOTAL
 };
 
+// Log-linear latency buckets in microseconds: 4 sub-buckets per power of two (~19% resolution) up to 2^32us
+#define PERF_MON_SUB_BUCKET_BITS 2
+#define PERF_MON_BUCKETS 128
+
+/**
+ * Per-thread counters of one metric id. Only the owning thread writes (relaxed load + store, no RMW),
+ * PrintStats reads them concurrently when merging shards.
+ */
+struct PerformanceHistogram
+{
+    std::atomic<uint64_t> totalTime{0};
+    std::atomic<uint64_t> maxTime{0};
+    std::atomic<uint32_t> count{0};
+    std::array<std::atomic<uint32_t>, PERF_MON_BUCKETS> buckets{};
+
+    void Record(uint64_t elapsed);
+    void Clear();
+};
+
+/**
+ * Merged snapshot of one metric id across all shards, built by PrintStats.
+ */
+struct PerformanceData
+{
+    uint64_t totalTime = 0;
+    uint64_t maxTime = 0;
+    uint32_t count = 0;
+    std::array<uint64_t, PERF_MON_BUCKETS> buckets{};
+
+    uint64_t Percentile(float fraction) const;
+};
+
+/**
+ * Per-thread tick cache counters of one value name. A hit means the value was read again within the same
+ * engine tick, whether or not it is configured as tick cached.
+ */
+struct PerformanceCacheCounter
+{
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+/**
+ * Per-thread samples of one counter, e.g. engine allocations per AI tick.
+ */
+struct PerformanceCount
+{
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> maxValue{0};
+    std::atomic<uint32_t> samples{0};
+};
+
 class PerfMonitorOperation
 {
 public:
-    PerfMonitorOperation(PerformanceData* data, std::string const name, PerformanceStack* stack);
+    PerfMonitorOperation(PerformanceHistogram* data, PerformanceStack* stack, uint64_t id);
     void finish();
 
 private:
-    PerformanceData* data;
-    std::string const name;
+    PerformanceHistogram* data;
     PerformanceStack* stack;
-    std::chrono::microseconds started;
+    uint64_t id;
+    std::chrono::steady_clock::time_point started;
+};
+
+/**
+ * Stack-allocated measurement. Costs one config check when perfMonEnabled is off; when on, one lookup in
+ * the calling thread's shard and no heap allocation once the metric id has been seen by that thread.
+ */
+class PerfMonitorScope
+{
+public:
+    PerfMonitorScope(PerformanceMetric metric, std::string_view name, PerformanceStack* stack = nullptr);
+    ~PerfMonitorScope();
+
+    PerfMonitorScope(PerfMonitorScope const&) = delete;
+    PerfMonitorScope& operator=(PerfMonitorScope const&) = delete;
+
+private:
+    PerformanceHistogram* data = nullptr;
+    PerformanceStack* stack = nullptr;
+    std::chrono::steady_clock::time_point started;
 };
 
 class PerfMonitor
@@ -59,9 +128,34 @@ public:
     PerfMonitorOperation* start(PerformanceMetric metric, std::string const name,
                                        PerformanceStack* stack = nullptr);
     void PrintStats(bool perTick = false, bool fullStack = false);
+    void PrintCacheStats();
     void Reset();
 
+    void RecordCacheAccess(std::string_view name, bool hit);
+    void RecordCount(std::string_view name, uint64_t value);
+
+    /**
+     * @brief Resolves the counters of (metric, name, parent scope) in the calling thread's shard
+     * @param id Receives the interned metric id, which nested scopes use as their parent
+     */
+    PerformanceHistogram* Resolve(PerformanceMetric metric, std::string_view name, uint64_t parent, uint64_t& id);
+
 private:
+    struct Shard
+    {
+        std::mutex lock;  // taken by the owner only when adding an id, and by PrintStats/Reset
+        std::unordered_map<uint64_t, std::unique_ptr<PerformanceHistogram>> data;
+        std::unordered_map<uint64_t, std::unique_ptr<PerformanceCacheCounter>> cache;
+        std::unordered_map<uint64_t, std::unique_ptr<PerformanceCount>> counts;
+    };
+
+    struct MetricName
+    {
+        PerformanceMetric metric;
+        std::string name;
+        uint64_t parent;
+    };
+
     PerfMonitor() = default;
     virtual ~PerfMonitor() = default;
 
@@ -71,7 +165,13 @@ private:
     PerfMonitor(PerfMonitor&&) = delete;
     PerfMonitor& operator=(PerfMonitor&&) = delete;
 
-    std::map<PerformanceMetric, std::map<std::string, PerformanceData*> > data;
+    Shard& GetShard();
+    void PrintCounts();
+    std::string const FormatName(uint64_t id, bool fullStack);
+    std::map<PerformanceMetric, std::map<std::string, PerformanceData>> Merge(bool fullStack);
+
+    std::vector<std::shared_ptr<Shard>> shards;
+    std::unordered_map<uint64_t, MetricName> names;
     std::mutex lock;
 };
 
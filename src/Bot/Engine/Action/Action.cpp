@@ -12,7 +12,7 @@ Value<Unit*>* Action::GetTargetValue() { return context->GetValue<Unit*>(GetTarg
 
 Unit* Action::GetTarget() { return GetTargetValue()->Get(); }
 
-ActionBasket::ActionBasket(ActionNode* action, float relevance, bool skipPrerequisites, Event event)
+ActionBasket::ActionBasket(ActionNode* action, float relevance, bool skipPrerequisites, Event const& event)
     : action(action), relevance(relevance), skipPrerequisites(skipPrerequisites), event(event), created(getMSTime())
 {
 }
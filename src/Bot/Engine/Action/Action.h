@@ -19,8 +19,8 @@ public:
         : relevance(relevance), name(name) {}                                  // name after relevance - whipowill
     NextAction(NextAction const& o) : relevance(o.relevance), name(o.name) {}  // name after relevance - whipowill
 
-    std::string const getName() { return name; }
-    float getRelevance() { return relevance; }
+    std::string const& getName() const { return name; }
+    float getRelevance() const { return relevance; }
 
     static std::vector<NextAction> merge(std::vector<NextAction> const& what, std::vector<NextAction> const& with)
     {
@@ -108,6 +108,7 @@ public:
         std::vector<NextAction> continuers = {}
     ) :
     name(std::move(name)),
+    nameHash(std::hash<std::string>()(this->name)),
     action(nullptr),
     continuers(continuers),
     alternatives(alternatives),
@@ -118,7 +119,8 @@ public:
 
     Action* getAction() { return action; }
     void setAction(Action* action) { this->action = action; }
-    const std::string getName() { return name; }
+    std::string const& getName() const { return name; }
+    size_t getNameHash() const { return nameHash; }  // hashed once, keys the action queue
 
     std::vector<NextAction> getContinuers()
     {
@@ -135,6 +137,7 @@ public:
 
 private:
     const std::string name;
+    const size_t nameHash;
     Action* action;
     std::vector<NextAction> continuers;
     std::vector<NextAction> alternatives;
@@ -144,13 +147,13 @@ private:
 class ActionBasket
 {
 public:
-    ActionBasket(ActionNode* action, float relevance, bool skipPrerequisites, Event event);
+    ActionBasket(ActionNode* action, float relevance, bool skipPrerequisites, Event const& event);
 
     virtual ~ActionBasket(void) {}
 
     float getRelevance() { return relevance; }
     ActionNode* getAction() { return action; }
-    Event getEvent() { return event; }
+    Event const& getEvent() const { return event; }
     bool isSkipPrerequisites() { return skipPrerequisites; }
     void AmendRelevance(float k) { relevance *= k; }
     void setRelevance(float relevance) { this->relevance = relevance; }
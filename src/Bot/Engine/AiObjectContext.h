@@ -6,12 +6,16 @@
 #ifndef _PLAYERBOT_AIOBJECTCONTEXT_H
 #define _PLAYERBOT_AIOBJECTCONTEXT_H
 
+#include <algorithm>
+#include <charconv>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #include "Common.h"
 #include "DynamicObject.h"
 #include "NamedObjectContext.h"
+#include "PerfMonitor.h"
 #include "PlayerbotAIAware.h"
 #include "Strategy.h"
 #include "Trigger.h"
@@ -42,23 +46,23 @@ public:
     virtual UntypedValue* GetUntypedValue(std::string const name);
 
     template <class T>
-    Value<T>* GetValue(std::string const name)
+    Value<T>* GetValue(std::string_view name)
     {
-        return dynamic_cast<Value<T>*>(GetUntypedValue(name));
+        return dynamic_cast<Value<T>*>(valueContexts.GetContextObject(name, nullptr, botAI));
     }
 
     template <class T>
-    Value<T>* GetValue(std::string const name, std::string const param)
+    Value<T>* GetValue(std::string_view name, std::string_view param)
     {
-        return GetValue<T>((std::string(name) + "::" + param));
+        return dynamic_cast<Value<T>*>(valueContexts.GetContextObject(name, &param, botAI));
     }
 
     template <class T>
-    Value<T>* GetValue(std::string const name, int32 param)
+    Value<T>* GetValue(std::string_view name, int32 param)
     {
-        std::ostringstream out;
-        out << param;
-        return GetValue<T>(name, out.str());
+        char buffer[16];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), param);
+        return GetValue<T>(name, std::string_view(buffer, result.ptr - buffer));
     }
 
     std::set<std::string> GetValues();
@@ -69,7 +73,37 @@ public:
     std::vector<std::string> Save();
     void Load(std::vector<std::string> data);
 
-    std::vector<std::string> performanceStack;
+    PerformanceStack performanceStack;
+
+    /**
+     * @brief Tick counter for tick cached values, bumped by the engine at the start of every tick
+     * and after every executed action
+     *
+     * 0 between two ticks of the owning engine, so reads from outside a tick (other bots, commands)
+     * always calculate the value again.
+     */
+    uint32 GetValueEpoch() const { return tickDepth ? valueEpoch : 0; }
+    void InvalidateTickValues()
+    {
+        if (!++valueEpoch)
+            valueEpoch = 1;
+    }
+    void BeginTick()
+    {
+        ++tickDepth;
+        InvalidateTickValues();
+    }
+    void EndTick() { --tickDepth; }
+
+    /**
+     * @brief Event driven triggers that received an ExternalEvent since the last processed tick
+     */
+    void QueueTriggerEvent(Trigger* trigger)
+    {
+        if (std::find(pendingTriggerEvents.begin(), pendingTriggerEvents.end(), trigger) == pendingTriggerEvents.end())
+            pendingTriggerEvents.push_back(trigger);
+    }
+    std::vector<Trigger*>& GetPendingTriggerEvents() { return pendingTriggerEvents; }
 
     static void BuildAllSharedContexts();
 
@@ -86,6 +120,10 @@ protected:
     NamedObjectContextList<UntypedValue> valueContexts;
 
 private:
+    uint32 valueEpoch = 1;  // 0 is reserved for "not calculated"
+    uint32 tickDepth = 0;   // engine ticks in progress, the engines of a bot share the context
+    std::vector<Trigger*> pendingTriggerEvents;
+
     static SharedNamedObjectContextList<Strategy> sharedStrategyContexts;
     static SharedNamedObjectContextList<Action> sharedActionContexts;
     static SharedNamedObjectContextList<Trigger> sharedTriggerContexts;
@@ -5,6 +5,8 @@
 
 #include "Engine.h"
 
+#include <algorithm>
+
 #include "Action.h"
 #include "Event.h"
 #include "PerfMonitor.h"
@@ -19,7 +21,7 @@ Engine::Engine(PlayerbotAI* botAI, AiObjectContext* factory) : PlayerbotAIAware(
     testMode = false;
 }
 
-bool ActionExecutionListeners::Before(Action* action, Event event)
+bool ActionExecutionListeners::Before(Action* action, Event const& event)
 {
     bool result = true;
     for (std::list<ActionExecutionListener*>::iterator i = listeners.begin(); i != listeners.end(); i++)
@@ -30,7 +32,7 @@ bool ActionExecutionListeners::Before(Action* action, Event event)
     return result;
 }
 
-void ActionExecutionListeners::After(Action* action, bool executed, Event event)
+void ActionExecutionListeners::After(Action* action, bool executed, Event const& event)
 {
     for (std::list<ActionExecutionListener*>::iterator i = listeners.begin(); i != listeners.end(); i++)
     {
@@ -38,7 +40,7 @@ void ActionExecutionListeners::After(Action* action, bool executed, Event event)
     }
 }
 
-bool ActionExecutionListeners::OverrideResult(Action* action, bool executed, Event event)
+bool ActionExecutionListeners::OverrideResult(Action* action, bool executed, Event const& event)
 {
     bool result = executed;
     for (std::list<ActionExecutionListener*>::iterator i = listeners.begin(); i != listeners.end(); i++)
@@ -49,7 +51,7 @@ bool ActionExecutionListeners::OverrideResult(Action* action, bool executed, Eve
     return result;
 }
 
-bool ActionExecutionListeners::AllowExecution(Action* action, Event event)
+bool ActionExecutionListeners::AllowExecution(Action* action, Event const& event)
 {
     bool result = true;
     for (std::list<ActionExecutionListener*>::iterator i = listeners.begin(); i != listeners.end(); i++)
@@ -90,13 +92,17 @@ void Engine::Reset()
 {
     strategyTypeMask = 0;
 
-    ActionNode* action = nullptr;
+    while (queue.Pop() != nullptr)
+    {
+    }
 
-    while ((action = queue.Pop()) != nullptr)
+    for (auto& [name, node] : actionNodes)
     {
-        delete action;
+        retiredActionNodes.push_back(std::move(node));
     }
 
+    actionNodes.clear();
+
     for (TriggerNode* trigger : triggers)
     {
         delete trigger;
@@ -104,6 +110,12 @@ void Engine::Reset()
 
     triggers.clear();
 
+    triggerGroups.clear();
+    polledTriggers.clear();
+    triggerTimers.clear();
+    eventTriggers.clear();
+    triggerScheduleDirty = true;
+
     for (Multiplier* multiplier : multipliers)
     {
         delete multiplier;
@@ -149,6 +161,9 @@ bool Engine::DoNextAction(Unit* unit, uint32 depth, bool minimal)
     ActionBasket* basket = nullptr;
     time_t currentTime = time(nullptr);
 
+    retiredActionNodes.clear();
+    aiObjectContext->BeginTick();
+
     // Update triggers and push default actions
     ProcessTriggers(minimal);
     PushDefaultActions();
@@ -168,7 +183,7 @@ bool Engine::DoNextAction(Unit* unit, uint32 depth, bool minimal)
         if (minimal && (relevance < 100))
             continue;
 
-        Event event = basket->getEvent();
+        Event const event = basket->getEvent();
         ActionNode* actionNode = queue.Pop();  // NOTE: Pop() deletes basket
         Action* action = InitializeAction(actionNode);
 
@@ -204,17 +219,16 @@ bool Engine::DoNextAction(Unit* unit, uint32 depth, bool minimal)
                     }
                 }
 
-                PerfMonitorOperation* pmo = sPerfMonitor.start(PERF_MON_ACTION, action->getName(), &aiObjectContext->performanceStack);
-                actionExecuted = ListenAndExecute(action, event);
-                if (pmo)
-                    pmo->finish();
+                {
+                    PerfMonitorScope scope(PERF_MON_ACTION, action->getName(), &aiObjectContext->performanceStack);
+                    actionExecuted = ListenAndExecute(action, event);
+                }
 
                 if (actionExecuted)
                 {
                     LogAction("A:%s - OK", action->getName().c_str());
                     MultiplyAndPush(actionNode->getContinuers(), relevance, false, event, "cont");
                     lastRelevance = relevance;
-                    delete actionNode;  // Safe memory management
                     break;
                 }
                 else
@@ -234,8 +248,6 @@ bool Engine::DoNextAction(Unit* unit, uint32 depth, bool minimal)
             LogAction("A:%s - USELESS", action->getName().c_str());
             lastRelevance = relevance;
         }
-
-        delete actionNode;  // Always delete after processing the action node
     }
 
     if (time(nullptr) - currentTime > 1)
@@ -248,32 +260,49 @@ bool Engine::DoNextAction(Unit* unit, uint32 depth, bool minimal)
 
     queue.RemoveExpired();
 
+    uint32 basketAllocations = queue.TakeAllocations();
+    if (sPlayerbotAIConfig.perfMonEnabled)
+    {
+        sPerfMonitor.RecordCount("Engine action baskets allocated per tick", basketAllocations);
+        sPerfMonitor.RecordCount("Engine action nodes allocated per tick", actionNodeAllocations);
+    }
+
+    actionNodeAllocations = 0;
+
+    aiObjectContext->EndTick();
+
     return actionExecuted;
 }
 
-ActionNode* Engine::CreateActionNode(std::string const name)
+ActionNode* Engine::CreateActionNode(std::string const& name)
 {
-    ActionNode* node = actionNodeFactories.GetContextObject(name, botAI);
-    if (node)
-        return node;
+    auto found = actionNodes.find(name);
+    if (found != actionNodes.end())
+        return found->second.get();
 
-    return new ActionNode(name,
-                          /*P*/ {},
-                          /*A*/ {},
-                          /*C*/ {});
+    ActionNode* node = actionNodeFactories.GetContextObject(name, botAI);
+    if (!node)
+        node = new ActionNode(name,
+                              /*P*/ {},
+                              /*A*/ {},
+                              /*C*/ {});
+
+    actionNodes.emplace(name, node);
+    ++actionNodeAllocations;
+    return node;
 }
 
 bool Engine::MultiplyAndPush(
-    std::vector<NextAction> actions,
+    std::vector<NextAction> const& actions,
     float forceRelevance,
     bool skipPrerequisites,
-    Event event,
+    Event const& event,
     char const* pushType
 )
 {
     bool pushed = false;
 
-    for (NextAction nextAction : actions)
+    for (NextAction const& nextAction : actions)
     {
         ActionNode* action = this->CreateActionNode(nextAction.getName());
 
@@ -289,20 +318,15 @@ bool Engine::MultiplyAndPush(
         if (k > 0)
         {
             this->LogAction("PUSH:%s - %f (%s)", action->getName().c_str(), k, pushType);
-            queue.Push(new ActionBasket(action, k, skipPrerequisites, event));
+            queue.Push(action, k, skipPrerequisites, event);
             pushed = true;
-
-            continue;
         }
-
-        delete action;
-
     }
 
     return pushed;
 }
 
-ActionResult Engine::ExecuteAction(std::string const name, Event event, std::string const qualifier)
+ActionResult Engine::ExecuteAction(std::string const name, Event const& event, std::string const qualifier)
 {
     bool result = false;
 
@@ -312,10 +336,7 @@ ActionResult Engine::ExecuteAction(std::string const name, Event event, std::str
 
     Action* action = InitializeAction(actionNode);
     if (!action)
-    {
-        delete actionNode;
         return ACTION_RESULT_UNKNOWN;
-    }
 
     if (!qualifier.empty())
     {
@@ -324,24 +345,16 @@ ActionResult Engine::ExecuteAction(std::string const name, Event event, std::str
     }
 
     if (!action->isUseful())
-    {
-        delete actionNode;
         return ACTION_RESULT_USELESS;
-    }
 
     if (!action->isPossible())
-    {
-        delete actionNode;
         return ACTION_RESULT_IMPOSSIBLE;
-    }
 
     action->MakeVerbose();
 
     result = ListenAndExecute(action, event);
     MultiplyAndPush(action->getContinuers(), 0.0f, false, event, "default");
 
-    delete actionNode;
-
     return result ? ACTION_RESULT_OK : ACTION_RESULT_FAILED;
 }
 
@@ -434,13 +447,26 @@ Strategy* Engine::GetStrategy(std::string const name)
     return i != strategies.end() ? i->second : nullptr;
 }
 
-void Engine::ProcessTriggers(bool minimal)
+namespace
 {
-    std::unordered_map<Trigger*, Event> fires;
-    uint32 now = getMSTime();
-    for (std::vector<TriggerNode*>::iterator i = triggers.begin(); i != triggers.end(); i++)
+    // Min-heap on due time; differences are compared signed so getMSTime wrap-around is harmless
+    bool TriggerTimerLater(std::pair<uint32, uint32> const& a, std::pair<uint32, uint32> const& b)
     {
-        TriggerNode* node = *i;
+        return int32(a.first - b.first) > 0;
+    }
+}
+
+void Engine::BuildTriggerSchedule()
+{
+    triggerGroups.clear();
+    polledTriggers.clear();
+    triggerTimers.clear();
+    eventTriggers.clear();
+
+    std::unordered_map<Trigger*, uint32> groups;
+    for (uint32 i = 0; i < triggers.size(); ++i)
+    {
+        TriggerNode* node = triggers[i];
         if (!node)
             continue;
 
@@ -454,52 +480,130 @@ void Engine::ProcessTriggers(bool minimal)
         if (!trigger)
             continue;
 
-        if (fires.find(trigger) != fires.end())
-            continue;
-
-        if (testMode || trigger->needCheck(now))
+        auto found = groups.find(trigger);
+        if (found == groups.end())
         {
-            if (minimal && node->getFirstRelevance() < 100)
-                continue;
+            found = groups.emplace(trigger, triggerGroups.size()).first;
+            triggerGroups.push_back({trigger, {}, false, Event()});
+        }
 
-            PerfMonitorOperation* pmo =
-                sPerfMonitor.start(PERF_MON_TRIGGER, trigger->getName(), &aiObjectContext->performanceStack);
-            Event event = trigger->Check();
-            if (pmo)
-                pmo->finish();
+        TriggerGroup& group = triggerGroups[found->second];
+        group.nodes.push_back(i);
+        group.urgent |= node->getFirstRelevance() >= 100;
+    }
 
-            if (!event)
-                continue;
+    uint32 now = getMSTime();
+    for (uint32 i = 0; i < triggerGroups.size(); ++i)
+    {
+        Trigger* trigger = triggerGroups[i].trigger;
+        if (trigger->IsEventDriven())
+            eventTriggers[trigger] = i;
+        else if (testMode || trigger->GetCheckInterval() < 2)
+            polledTriggers.push_back(i);
+        else
+            triggerTimers.emplace_back(now, i);
+    }
 
-            fires[trigger] = event;
-            LogAction("T:%s", trigger->getName().c_str());
-        }
+    std::make_heap(triggerTimers.begin(), triggerTimers.end(), TriggerTimerLater);
+
+    triggerScheduleDirty = false;
+}
+
+void Engine::CheckTrigger(uint32 groupIndex, bool minimal)
+{
+    TriggerGroup& group = triggerGroups[groupIndex];
+    if (minimal && !group.urgent)
+        return;
+
+    Trigger* trigger = group.trigger;
+    checkedTriggers.push_back(trigger);
+
+    Event event;
+    {
+        PerfMonitorScope scope(PERF_MON_TRIGGER, trigger->getName(), &aiObjectContext->performanceStack);
+        event = trigger->Check();
     }
 
-    for (std::vector<TriggerNode*>::iterator i = triggers.begin(); i != triggers.end(); i++)
+    if (!event)
+        return;
+
+    group.event = event;
+    firedTriggers.push_back(groupIndex);
+    LogAction("T:%s", trigger->getName().c_str());
+}
+
+void Engine::ProcessTriggers(bool minimal)
+{
+    if (triggerScheduleDirty)
+        BuildTriggerSchedule();
+
+    firedTriggers.clear();
+    checkedTriggers.clear();
+
+    for (uint32 groupIndex : polledTriggers)
+        CheckTrigger(groupIndex, minimal);
+
+    uint32 now = getMSTime();
+    while (!triggerTimers.empty() && int32(triggerTimers.front().first - now) <= 0)
     {
-        TriggerNode* node = *i;
-        Trigger* trigger = node->getTrigger();
-        if (fires.find(trigger) == fires.end())
-            continue;
+        std::pop_heap(triggerTimers.begin(), triggerTimers.end(), TriggerTimerLater);
+        std::pair<uint32, uint32>& timer = triggerTimers.back();
+
+        // The trigger is shared with the other engines of this bot, which may have checked it recently
+        Trigger* trigger = triggerGroups[timer.second].trigger;
+        if (trigger->needCheck(now))
+            CheckTrigger(timer.second, minimal);
 
-        Event event = fires[trigger];
-        MultiplyAndPush(node->getHandlers(), 0.0f, false, event, "trigger");
+        timer.first = trigger->GetNextCheckTime();
+        std::push_heap(triggerTimers.begin(), triggerTimers.end(), TriggerTimerLater);
+    }
+
+    std::vector<Trigger*>& pendingEvents = aiObjectContext->GetPendingTriggerEvents();
+    for (Trigger* trigger : pendingEvents)
+    {
+        auto found = eventTriggers.find(trigger);
+        if (found != eventTriggers.end())
+            CheckTrigger(found->second, minimal);
     }
 
-    for (std::vector<TriggerNode*>::iterator i = triggers.begin(); i != triggers.end(); i++)
+    // Push handlers in strategy order, as relevance ties are resolved first-pushed-first
+    firedNodes.clear();
+    for (uint32 groupIndex : firedTriggers)
     {
-        if (Trigger* trigger = (*i)->getTrigger())
-            trigger->Reset();
+        for (uint32 node : triggerGroups[groupIndex].nodes)
+            firedNodes.emplace_back(node, groupIndex);
     }
+
+    std::sort(firedNodes.begin(), firedNodes.end());
+
+    for (std::pair<uint32, uint32> const& fired : firedNodes)
+        MultiplyAndPush(triggers[fired.first]->getHandlers(), 0.0f, false, triggerGroups[fired.second].event,
+                        "trigger");
+
+    for (uint32 groupIndex : firedTriggers)
+        triggerGroups[groupIndex].event = Event();
+
+    for (Trigger* trigger : checkedTriggers)
+        trigger->Reset();
+
+    // Events without a handler in this engine stay pending for the engine that has one, e.g. a quest share
+    // received in combat is handled once the non combat engine runs again. Non urgent ones skipped by a
+    // minimal tick wait for the next full tick.
+    auto handled = [this, minimal](Trigger* trigger)
+    {
+        auto found = eventTriggers.find(trigger);
+        return found != eventTriggers.end() && (!minimal || triggerGroups[found->second].urgent);
+    };
+
+    pendingEvents.erase(std::remove_if(pendingEvents.begin(), pendingEvents.end(), handled), pendingEvents.end());
 }
 
 void Engine::PushDefaultActions()
 {
+    Event const emptyEvent;
     for (std::map<std::string, Strategy*>::iterator i = strategies.begin(); i != strategies.end(); i++)
     {
         Strategy* strategy = i->second;
-        Event emptyEvent;
         MultiplyAndPush(strategy->getDefaultActions(), 0.0f, false, emptyEvent, "default");
     }
 }
@@ -531,13 +635,11 @@ std::vector<std::string> Engine::GetStrategies()
     return result;
 }
 
-void Engine::PushAgain(ActionNode* actionNode, float relevance, Event event)
+void Engine::PushAgain(ActionNode* actionNode, float relevance, Event const& event)
 {
     std::vector<NextAction> nextAction = { NextAction(actionNode->getName(), relevance) };
 
     MultiplyAndPush(nextAction, relevance, true, event, "again");
-
-    delete actionNode;
 }
 
 bool Engine::ContainsStrategy(StrategyType type)
@@ -562,7 +664,7 @@ Action* Engine::InitializeAction(ActionNode* actionNode)
     return action;
 }
 
-bool Engine::ListenAndExecute(Action* action, Event event)
+bool Engine::ListenAndExecute(Action* action, Event const& event)
 {
     bool actionExecuted = false;
 
@@ -576,6 +678,9 @@ bool Engine::ListenAndExecute(Action* action, Event event)
     if (actionExecutionListeners.Before(action, event))
     {
         actionExecuted = actionExecutionListeners.AllowExecution(action, event) ? action->Execute(event) : true;
+
+        // The action may have changed what tick cached values were calculated from
+        aiObjectContext->InvalidateTickValues();
     }
 
     if (botAI->HasStrategy("debug", BOT_STATE_NON_COMBAT))
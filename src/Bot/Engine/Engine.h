@@ -7,6 +7,9 @@
 #define _PLAYERBOT_ENGINE_H
 
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "Multiplier.h"
 #include "PlayerbotAIAware.h"
@@ -35,10 +38,10 @@ class ActionExecutionListener
 public:
     virtual ~ActionExecutionListener(){};
 
-    virtual bool Before(Action* action, Event event) = 0;
-    virtual bool AllowExecution(Action* action, Event event) = 0;
-    virtual void After(Action* action, bool executed, Event event) = 0;
-    virtual bool OverrideResult(Action* action, bool executed, Event event) = 0;
+    virtual bool Before(Action* action, Event const& event) = 0;
+    virtual bool AllowExecution(Action* action, Event const& event) = 0;
+    virtual void After(Action* action, bool executed, Event const& event) = 0;
+    virtual bool OverrideResult(Action* action, bool executed, Event const& event) = 0;
 };
 
 class ActionExecutionListeners : public ActionExecutionListener
@@ -46,10 +49,10 @@ class ActionExecutionListeners : public ActionExecutionListener
 public:
     virtual ~ActionExecutionListeners();
 
-    bool Before(Action* action, Event event) override;
-    bool AllowExecution(Action* action, Event event) override;
-    void After(Action* action, bool executed, Event event) override;
-    bool OverrideResult(Action* action, bool executed, Event event) override;
+    bool Before(Action* action, Event const& event) override;
+    bool AllowExecution(Action* action, Event const& event) override;
+    void After(Action* action, bool executed, Event const& event) override;
+    bool OverrideResult(Action* action, bool executed, Event const& event) override;
 
     void Add(ActionExecutionListener* listener) { listeners.push_back(listener); }
 
@@ -80,7 +83,7 @@ public:
     std::string const GetLastAction() { return lastAction; }
 
     virtual bool DoNextAction(Unit*, uint32 depth = 0, bool minimal = false);
-    ActionResult ExecuteAction(std::string const name, Event event = Event(), std::string const qualifier = "");
+    ActionResult ExecuteAction(std::string const name, Event const& event = Event(), std::string const qualifier = "");
 
     void AddActionExecutionListener(ActionExecutionListener* listener) { actionExecutionListeners.Add(listener); }
 
@@ -91,21 +94,61 @@ public:
     bool testMode;
 
 private:
-    bool MultiplyAndPush(std::vector<NextAction> actions, float forceRelevance, bool skipPrerequisites, Event event,
-                         const char* pushType);
+    bool MultiplyAndPush(std::vector<NextAction> const& actions, float forceRelevance, bool skipPrerequisites,
+                         Event const& event, const char* pushType);
     void Reset();
     void ProcessTriggers(bool minimal);
+    void BuildTriggerSchedule();
+    void CheckTrigger(uint32 groupIndex, bool minimal);
     void PushDefaultActions();
-    void PushAgain(ActionNode* actionNode, float relevance, Event event);
-    ActionNode* CreateActionNode(std::string const name);
+    void PushAgain(ActionNode* actionNode, float relevance, Event const& event);
+    ActionNode* CreateActionNode(std::string const& name);
     Action* InitializeAction(ActionNode* actionNode);
-    bool ListenAndExecute(Action* action, Event event);
+    bool ListenAndExecute(Action* action, Event const& event);
 
     void LogAction(char const* format, ...);
     void LogValues();
 
     ActionExecutionListeners actionExecutionListeners;
 
+    /**
+     * @brief All trigger nodes sharing one trigger, checked at most once per tick
+     */
+    struct TriggerGroup
+    {
+        Trigger* trigger;
+        std::vector<uint32> nodes;  // indices into triggers, in strategy order
+        bool urgent;                // has a node with first relevance >= 100, checked in minimal ticks
+        Event event;                // set while the trigger has fired in the current tick
+    };
+
+    /**
+     * @brief Trigger schedule, rebuilt lazily after Init. Per-tick trigger cost scales with the
+     * polled and due triggers only:
+     * - checkInterval < 2: polled every tick
+     * - checkInterval >= 2: min-heap of next due times
+     * - event driven: checked only when the context reports a pending ExternalEvent
+     */
+    std::vector<TriggerGroup> triggerGroups;
+    std::vector<uint32> polledTriggers;
+    std::vector<std::pair<uint32, uint32>> triggerTimers;  // (due ms, group), heap ordered by due
+    std::unordered_map<Trigger*, uint32> eventTriggers;     // trigger -> group
+    std::vector<uint32> firedTriggers;                      // groups fired this tick
+    std::vector<Trigger*> checkedTriggers;                  // triggers to Reset at the end of the tick
+    std::vector<std::pair<uint32, uint32>> firedNodes;      // (node, group), reused between ticks
+    bool triggerScheduleDirty = true;
+
+    /**
+     * @brief Action plan: one ActionNode per action name, built from the strategies' node factories on
+     * first use after Init and owned by the engine. Queued baskets reference these nodes, so pushing an
+     * action no longer creates or deletes nodes.
+     */
+    std::unordered_map<std::string, std::unique_ptr<ActionNode>> actionNodes;
+    // Nodes of the previous plan. An action may change strategies while its node is still in use, so
+    // they are released at the start of the next tick
+    std::vector<std::unique_ptr<ActionNode>> retiredActionNodes;
+    uint32 actionNodeAllocations = 0;  // plan nodes created since the last tick, for the perf monitor
+
 protected:
     Queue queue;
     std::vector<TriggerNode*> triggers;
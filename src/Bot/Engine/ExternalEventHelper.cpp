@@ -53,6 +53,9 @@ void ExternalEventHelper::HandlePacket(std::map<uint16, std::string>& handlers,
 
     WorldPacket p(packet);
     trigger->ExternalEvent(p, owner);
+
+    if (trigger->IsEventDriven())
+        aiObjectContext->QueueTriggerEvent(trigger);
 }
 
 bool ExternalEventHelper::HandleCommand(std::string const name, std::string const param, Player* owner)
@@ -63,5 +66,8 @@ bool ExternalEventHelper::HandleCommand(std::string const name, std::string cons
 
     trigger->ExternalEvent(param, owner);
 
+    if (trigger->IsEventDriven())
+        aiObjectContext->QueueTriggerEvent(trigger);
+
     return true;
 }
@@ -8,6 +8,7 @@
 
 #include <list>
 #include <set>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -17,6 +18,115 @@
 
 class PlayerbotAI;
 
+/**
+ * FNV-1a hash of an object name. Qualified names ("name::qualifier") are hashed incrementally so that
+ * NamedObjectHash(qualifier, NamedObjectHash("::", NamedObjectHash(name))) equals the hash of the full name.
+ * constexpr, so literal names fold at compile time.
+ */
+constexpr uint64 NamedObjectHash(std::string_view text, uint64 hash = 14695981039346656037ULL)
+{
+    for (char c : text)
+    {
+        hash ^= static_cast<uint8>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * Flat open-addressing index from interned name id to created object. Slots keep a pointer to the owning
+ * string key (stable node address in the created map) to reject hash collisions without allocating.
+ */
+template <class T>
+class NamedObjectIndex
+{
+public:
+    struct Slot
+    {
+        uint64 key = 0;
+        std::string const* name = nullptr;
+        T* object = nullptr;
+    };
+
+    Slot const* Find(uint64 key, std::string_view name, std::string_view const* qualifier) const
+    {
+        if (slots.empty())
+            return nullptr;
+
+        size_t mask = slots.size() - 1;
+        for (size_t i = key & mask;; i = (i + 1) & mask)
+        {
+            Slot const& slot = slots[i];
+            if (!slot.name)
+                return nullptr;
+
+            if (slot.key == key && Matches(*slot.name, name, qualifier))
+                return &slot;
+        }
+    }
+
+    void Insert(uint64 key, std::string const* name, T* object)
+    {
+        if ((count + 1) * 2 > slots.size())
+            Grow();
+
+        Place(key, name, object);
+        ++count;
+    }
+
+    void Clear()
+    {
+        slots.clear();
+        count = 0;
+    }
+
+    static uint64 Key(std::string_view name, std::string_view const* qualifier)
+    {
+        uint64 hash = NamedObjectHash(name);
+        if (qualifier)
+            hash = NamedObjectHash(*qualifier, NamedObjectHash("::", hash));
+
+        return hash;
+    }
+
+private:
+    static bool Matches(std::string const& full, std::string_view name, std::string_view const* qualifier)
+    {
+        if (!qualifier)
+            return full == name;
+
+        return full.size() == name.size() + 2 + qualifier->size() && full.compare(0, name.size(), name) == 0 &&
+               full.compare(name.size(), 2, "::") == 0 && full.compare(name.size() + 2, qualifier->size(), *qualifier) == 0;
+    }
+
+    void Place(uint64 key, std::string const* name, T* object)
+    {
+        size_t mask = slots.size() - 1;
+        size_t i = key & mask;
+        while (slots[i].name)
+            i = (i + 1) & mask;
+
+        slots[i] = {key, name, object};
+    }
+
+    void Grow()
+    {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(old.empty() ? 64 : old.size() * 2);
+
+        for (Slot const& slot : old)
+        {
+            if (slot.name)
+                Place(slot.key, slot.name, slot.object);
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+};
+
 class Qualified
 {
 public:
@@ -175,6 +285,7 @@ public:
                 delete i->second;
         }
 
+        index.Clear();
         created.clear();
     }
 
@@ -203,13 +314,32 @@ public:
 
     T* GetContextObject(const std::string& name, PlayerbotAI* botAI)
     {
-        if (created.find(name) == created.end())
+        return GetContextObject(std::string_view(name), nullptr, botAI);
+    }
+
+    /**
+     * Hot path: resolves "name" or "name::qualifier" through the interned id index without building the
+     * qualified string. The string keyed map is only touched the first time an object is created.
+     */
+    T* GetContextObject(std::string_view name, std::string_view const* qualifier, PlayerbotAI* botAI)
+    {
+        uint64 key = NamedObjectIndex<T>::Key(name, qualifier);
+        if (typename NamedObjectIndex<T>::Slot const* slot = index.Find(key, name, qualifier))
+            return slot->object;
+
+        std::string fullName(name);
+        if (qualifier)
         {
-            if (T* object = create(name, botAI))
-                return created[name] = object;
+            fullName.append("::");
+            fullName.append(*qualifier);
         }
 
-        return created[name];
+        auto found = created.find(fullName);
+        if (found == created.end())
+            found = created.emplace(fullName, create(fullName, botAI)).first;
+
+        index.Insert(key, &found->first, found->second);
+        return found->second;
     }
 
     std::set<std::string> GetSiblings(const std::string& name)
@@ -252,6 +382,9 @@ public:
 
         return result;
     }
+
+private:
+    NamedObjectIndex<T> index;
 };
 
 template <class T>
@@ -25,6 +25,11 @@ public:
     virtual void ExternalEvent([[maybe_unused]] std::string const param, [[maybe_unused]] Player* owner = nullptr) {}
     virtual void ExternalEvent([[maybe_unused]] WorldPacket& packet, [[maybe_unused]] Player* owner = nullptr) {}
     virtual bool IsActive() { return false; }
+
+    /**
+     * @brief Event driven triggers only fire after ExternalEvent and are never polled by the engine
+     */
+    virtual bool IsEventDriven() { return false; }
     virtual std::vector<NextAction> getHandlers() { return {}; }
     void Update() {}
     virtual void Reset() {}
@@ -33,6 +38,8 @@ public:
     virtual std::string const GetTargetName() { return "self target"; }
 
     bool needCheck(uint32 now);
+    int32_t GetCheckInterval() const { return checkInterval; }
+    uint32_t GetNextCheckTime() const { return lastCheckTime + checkInterval; }
 
 protected:
     int32_t checkInterval;
@@ -14,6 +14,29 @@ UnitCalculatedValue::UnitCalculatedValue(PlayerbotAI* botAI, std::string const n
 {
 }
 
+bool UntypedValue::IsCachedThisTick()
+{
+    if (!context)
+        return false;
+
+    // resolved again after .playerbots reload config changed the list
+    if (tickCachedVersion != sPlayerbotAIConfig.tickCachedValuesVersion)
+    {
+        tickCached = sPlayerbotAIConfig.IsTickCachedValue(getName());
+        tickCachedVersion = sPlayerbotAIConfig.tickCachedValuesVersion;
+    }
+
+    // outside the owner's tick the epoch is 0 and never matches
+    uint32 epoch = context->GetValueEpoch();
+    bool sameTick = epoch && tickCacheEpoch == epoch;
+    tickCacheEpoch = epoch;
+
+    if (sPlayerbotAIConfig.perfMonEnabled)
+        sPerfMonitor.RecordCacheAccess(getName(), sameTick);
+
+    return tickCached && sameTick;
+}
+
 std::string const UnitCalculatedValue::Format()
 {
     Unit* unit = Calculate();
@@ -123,11 +146,12 @@ Unit* UnitCalculatedValue::Get()
 {
     if (checkInterval < 2)
     {
-        PerfMonitorOperation* pmo = sPerfMonitor.start(
-            PERF_MON_VALUE, this->getName(), this->context ? &this->context->performanceStack : nullptr);
+        if (IsCachedThisTick())
+            return value;
+
+        PerfMonitorScope scope(PERF_MON_VALUE, this->getName(),
+                               this->context ? &this->context->performanceStack : nullptr);
         value = Calculate();
-        if (pmo)
-            pmo->finish();
     }
     else
     {
@@ -135,11 +159,9 @@ Unit* UnitCalculatedValue::Get()
         if (!lastCheckTime || now - lastCheckTime >= checkInterval)
         {
             lastCheckTime = now;
-            PerfMonitorOperation* pmo = sPerfMonitor.start(
-                PERF_MON_VALUE, this->getName(), this->context ? &this->context->performanceStack : nullptr);
+            PerfMonitorScope scope(PERF_MON_VALUE, this->getName(),
+                                   this->context ? &this->context->performanceStack : nullptr);
             value = Calculate();
-            if (pmo)
-                pmo->finish();
         }
     }
     // Prevent crashing by InWorld check
@@ -39,6 +39,23 @@ public:
     virtual std::string const Format() { return "?"; }
     virtual std::string const Save() { return "?"; }
     virtual bool Load([[maybe_unused]] std::string const value) { return false; }
+
+protected:
+    /**
+     * @brief Checks whether the value was already calculated during the current tick of its bot's engine
+     * @return true only for values listed in AiPlayerbot.TickCachedValues; always false otherwise and for
+     * reads between two ticks
+     *
+     * Every call marks the value as calculated for the current tick. With the performance monitor
+     * enabled, hits and misses are counted for every value so candidates for caching can be found.
+     */
+    bool IsCachedThisTick();
+    void ResetTickCache() { tickCacheEpoch = 0; }
+
+private:
+    bool tickCached = false;      // lazily resolved from config
+    uint32 tickCachedVersion = 0;  // config load it was resolved for, 0 = not checked yet
+    uint32 tickCacheEpoch = 0;
 };
 
 template <class T>
@@ -72,6 +89,9 @@ public:
     {
         if (checkInterval < 2)
         {
+            if (IsCachedThisTick())
+                return value;
+
             // PerfMonitorOperation* pmo = sPerfMonitor.start(PERF_MON_VALUE, this->getName(),
             // this->context ? &this->context->performanceStack : nullptr);
             value = Calculate();
@@ -105,6 +125,9 @@ public:
     {
         if (checkInterval < 2)
         {
+            if (IsCachedThisTick())
+                return value;
+
             // PerfMonitorOperation* pmo = sPerfMonitor.start(PERF_MON_VALUE, this->getName(),
             // this->context ? &this->context->performanceStack : nullptr);
             value = Calculate();
@@ -126,9 +149,17 @@ public:
         }
         return value;
     }
-    void Set(T val) override { value = val; }
+    void Set(T val) override
+    {
+        value = val;
+        ResetTickCache();
+    }
     void Update() override {}
-    void Reset() override { lastCheckTime = 0; }
+    void Reset() override
+    {
+        lastCheckTime = 0;
+        ResetTickCache();
+    }
 
 protected:
     virtual T Calculate() = 0;
@@ -154,11 +185,9 @@ public:
         {
             this->lastCheckTime = now;
 
-            PerfMonitorOperation* pmo = sPerfMonitor.start(
-                PERF_MON_VALUE, this->getName(), this->context ? &this->context->performanceStack : nullptr);
+            PerfMonitorScope scope(PERF_MON_VALUE, this->getName(),
+                                   this->context ? &this->context->performanceStack : nullptr);
             this->value = this->Calculate();
-            if (pmo)
-                pmo->finish();
         }
 
         return this->value;
@@ -7,21 +7,31 @@
 
 #include "Playerbots.h"
 
-Event::Event(std::string const source, ObjectGuid object, Player* owner) : source(source), owner(owner)
+Event::Event(std::string const source, ObjectGuid object, Player* owner) : owner(owner)
 {
+    WorldPacket packet;
     packet << object;
+    payload = std::make_shared<Payload const>(source, std::string(), std::move(packet));
 }
 
-ObjectGuid Event::getObject()
+ObjectGuid Event::getObject() const
 {
+    WorldPacket const& packet = getPacket();
     if (packet.empty())
         return ObjectGuid::Empty;
 
-    WorldPacket p(packet);
-    p.rpos(0);
+    // The guid leads the packet, read it in place instead of copying the packet for a read position
+    return ObjectGuid(packet.read<uint64>(0));
+}
 
-    ObjectGuid guid;
-    p >> guid;
+std::string const& Event::EmptyString()
+{
+    static std::string const empty;
+    return empty;
+}
 
-    return guid;
+WorldPacket const& Event::EmptyPacket()
+{
+    static WorldPacket const empty;
+    return empty;
 }
@@ -6,39 +6,59 @@
 #ifndef _PLAYERBOT_EVENT_H
 #define _PLAYERBOT_EVENT_H
 
+#include <memory>
+
 #include "WorldPacket.h"
 
 class ObjectGuid;
 class Player;
 
+/**
+ * Cheap handle over an immutable, reference-counted payload (source, param and packet bytes).
+ * Copying an Event only bumps the reference count, so it can be passed through the engine,
+ * the listener chain and every action hop without duplicating the packet buffer. Readers that
+ * need to move the read cursor take their own copy: WorldPacket p(event.getPacket());
+ */
 class Event
 {
 public:
-    Event(Event const& other) : source(other.source), param(other.param), packet(other.packet), owner(other.owner) {}
     Event() {}
-    Event(std::string const source) : source(source) {}
+    Event(std::string const source) : payload(std::make_shared<Payload const>(source)) {}
     Event(std::string const source, std::string const param, Player* owner = nullptr)
-        : source(source), param(param), owner(owner)
+        : payload(std::make_shared<Payload const>(source, param)), owner(owner)
     {
     }
-    Event(std::string const source, WorldPacket& packet, Player* owner = nullptr)
-        : source(source), packet(packet), owner(owner)
+    Event(std::string const source, WorldPacket const& packet, Player* owner = nullptr)
+        : payload(std::make_shared<Payload const>(source, std::string(), packet)), owner(owner)
     {
     }
     Event(std::string const source, ObjectGuid object, Player* owner = nullptr);
     virtual ~Event() {}
 
-    std::string const GetSource() { return source; }
-    std::string const getParam() { return param; }
-    WorldPacket& getPacket() { return packet; }
-    ObjectGuid getObject();
-    Player* getOwner() { return owner; }
-    bool operator!() const { return source.empty(); }
+    std::string const& GetSource() const { return payload ? payload->source : EmptyString(); }
+    std::string const& getParam() const { return payload ? payload->param : EmptyString(); }
+    WorldPacket const& getPacket() const { return payload ? payload->packet : EmptyPacket(); }
+    ObjectGuid getObject() const;
+    Player* getOwner() const { return owner; }
+    bool operator!() const { return !payload || payload->source.empty(); }
 
 protected:
-    std::string source;
-    std::string param;
-    WorldPacket packet;
+    struct Payload
+    {
+        Payload(std::string source, std::string param = std::string(), WorldPacket packet = WorldPacket())
+            : source(std::move(source)), param(std::move(param)), packet(std::move(packet))
+        {
+        }
+
+        std::string const source;
+        std::string const param;
+        WorldPacket const packet;
+    };
+
+    static std::string const& EmptyString();
+    static WorldPacket const& EmptyPacket();
+
+    std::shared_ptr<Payload const> payload;
     Player* owner = nullptr;
 };
 
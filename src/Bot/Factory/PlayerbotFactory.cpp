@@ -5,6 +5,7 @@
 
 #include "PlayerbotFactory.h"
 
+#include <algorithm>
 #include <array>
 #include <utility>
 
@@ -37,6 +38,7 @@
 #include "SharedDefines.h"
 #include "StatsWeightCalculator.h"
 #include "World.h"
+#include "WorkerPool.h"
 #include "AiObjectContext.h"
 #include "ItemPackets.h"
 
@@ -2002,142 +2004,182 @@ void PlayerbotFactory::InitEquipment(bool incremental, bool second_chance)
         return;
     }
 
-    std::unordered_map<uint8, std::vector<uint32>> items;
-    // int tab = AiFactory::GetPlayerSpecTab(bot);
+    if (second_chance)
+    {
+        for (int32 slot : initSlotsOrder)
+        {
+            if (IsInitEquipmentSlot(slot) && bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot))
+                bot->DestroyItem(INVENTORY_SLOT_BAG_0, slot, true);
+        }
+    }
 
-    uint32 blevel = bot->GetLevel();
-    int32 delta = std::min(blevel, 10u);
+    // Choosing the gear only reads the bot and the item caches, equipping it has to happen on this thread
+    EquipmentPlan plan;
+    PlanEquipment(plan);
+    ApplyEquipmentPlan(plan, incremental, second_chance);
+}
 
-    StatsWeightCalculator calculator(bot);
-    for (int32 slot : initSlotsOrder)
-    {
-        if (slot == EQUIPMENT_SLOT_TABARD || slot == EQUIPMENT_SLOT_BODY)
-            continue;
+bool PlayerbotFactory::IsInitEquipmentSlot(uint8 slot) const
+{
+    if (slot == EQUIPMENT_SLOT_TABARD || slot == EQUIPMENT_SLOT_BODY)
+        return false;
 
-        if (level < 50 && (slot == EQUIPMENT_SLOT_TRINKET1 || slot == EQUIPMENT_SLOT_TRINKET2))
-            continue;
+    if (level < 50 && (slot == EQUIPMENT_SLOT_TRINKET1 || slot == EQUIPMENT_SLOT_TRINKET2))
+        return false;
 
-        if (level < 30 && (slot == EQUIPMENT_SLOT_NECK || slot == EQUIPMENT_SLOT_HEAD))
-            continue;
+    if (level < 30 && (slot == EQUIPMENT_SLOT_NECK || slot == EQUIPMENT_SLOT_HEAD))
+        return false;
 
-        if (level < 20 && (slot == EQUIPMENT_SLOT_FINGER1 || slot == EQUIPMENT_SLOT_FINGER2))
-            continue;
+    if (level < 20 && (slot == EQUIPMENT_SLOT_FINGER1 || slot == EQUIPMENT_SLOT_FINGER2))
+        return false;
 
-        if (level < 5 && (slot != EQUIPMENT_SLOT_MAINHAND) && (slot != EQUIPMENT_SLOT_OFFHAND) &&
-            (slot != EQUIPMENT_SLOT_FEET) && (slot != EQUIPMENT_SLOT_LEGS) && (slot != EQUIPMENT_SLOT_CHEST) &&
-            (slot != EQUIPMENT_SLOT_RANGED))
-            continue;
+    if (level < 5 && (slot != EQUIPMENT_SLOT_MAINHAND) && (slot != EQUIPMENT_SLOT_OFFHAND) &&
+        (slot != EQUIPMENT_SLOT_FEET) && (slot != EQUIPMENT_SLOT_LEGS) && (slot != EQUIPMENT_SLOT_CHEST) &&
+        (slot != EQUIPMENT_SLOT_RANGED))
+        return false;
 
-        Item* oldItem = bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
+    return true;
+}
 
-        if (second_chance && oldItem)
-        {
-            bot->DestroyItem(INVENTORY_SLOT_BAG_0, slot, true);
-        }
+void PlayerbotFactory::PlanEquipment(EquipmentPlan& plan)
+{
+    std::vector<uint8> slots;
+    for (int32 slot : initSlotsOrder)
+    {
+        if (IsInitEquipmentSlot(slot))
+            slots.push_back(slot);
+    }
 
-        oldItem = bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
+    if (slots.empty())
+        return;
 
-        int32 desiredQuality = itemQuality;
-        if (urand(0, 100) < 100 * sPlayerbotAIConfig.randomGearLoweringChance && desiredQuality > ITEM_QUALITY_NORMAL)
-            desiredQuality--;
+    // Slots are planned independently, each part scores with its own calculator
+    uint32 const parts = std::clamp<uint32>(sPlayerbotAIConfig.gearInitThreads, 1, slots.size());
+    WorkerPool::instance().Run(parts,
+                               [this, &plan, &slots, parts](uint32 first)
+                               {
+                                   StatsWeightCalculator calculator(bot);
+                                   for (uint32 i = first; i < slots.size(); i += parts)
+                                       PlanEquipmentSlot(slots[i], calculator, plan.candidates[slots[i]]);
+                               });
+}
 
-        do
+void PlayerbotFactory::PlanEquipmentSlot(uint8 slot, StatsWeightCalculator& calculator,
+                                         std::vector<std::pair<float, uint32>>& candidates)
+{
+    std::vector<uint32> ids;
+
+    uint32 blevel = bot->GetLevel();
+    int32 delta = std::min(blevel, 10u);
+
+    int32 desiredQuality = itemQuality;
+    if (urand(0, 100) < 100 * sPlayerbotAIConfig.randomGearLoweringChance && desiredQuality > ITEM_QUALITY_NORMAL)
+        desiredQuality--;
+
+    do
+    {
+        for (uint32 requiredLevel = bot->GetLevel(); requiredLevel > std::max((int32)bot->GetLevel() - delta, 0);
+             requiredLevel--)
         {
-            for (uint32 requiredLevel = bot->GetLevel(); requiredLevel > std::max((int32)bot->GetLevel() - delta, 0);
-                 requiredLevel--)
+            for (InventoryType inventoryType : GetPossibleInventoryTypeListBySlot((EquipmentSlots)slot))
             {
-                for (InventoryType inventoryType : GetPossibleInventoryTypeListBySlot((EquipmentSlots)slot))
+                for (uint32 itemId : sRandomItemMgr.GetCachedEquipments(requiredLevel, inventoryType))
                 {
-                    for (uint32 itemId : sRandomItemMgr.GetCachedEquipments(requiredLevel, inventoryType))
-                    {
-                        uint32 skipProb = 25;
-                        if (urand(1, 100) <= skipProb)
-                            continue;
+                    uint32 skipProb = 25;
+                    if (urand(1, 100) <= skipProb)
+                        continue;
 
-                        // disable next expansion gear
-                        if (sPlayerbotAIConfig.limitGearExpansion && bot->GetLevel() <= 60 && itemId >= 23728)
-                            continue;
+                    // disable next expansion gear
+                    if (sPlayerbotAIConfig.limitGearExpansion && bot->GetLevel() <= 60 && itemId >= 23728)
+                        continue;
 
-                        if (sPlayerbotAIConfig.limitGearExpansion && bot->GetLevel() <= 70 && itemId >= 35570 &&
-                            itemId != 36737 && itemId != 37739 &&
-                            itemId != 37740)  // transition point from TBC -> WOTLK isn't as clear, and there are other
-                                              // wearable TBC items above 35570 but nothing of significance
-                            continue;
+                    if (sPlayerbotAIConfig.limitGearExpansion && bot->GetLevel() <= 70 && itemId >= 35570 &&
+                        itemId != 36737 && itemId != 37739 &&
+                        itemId != 37740)  // transition point from TBC -> WOTLK isn't as clear, and there are other
+                                          // wearable TBC items above 35570 but nothing of significance
+                        continue;
 
-                        ItemTemplate const* proto = sObjectMgr->GetItemTemplate(itemId);
-                        if (!proto)
-                            continue;
+                    ItemTemplate const* proto = sObjectMgr->GetItemTemplate(itemId);
+                    if (!proto)
+                        continue;
 
-                        bool shouldCheckGS = desiredQuality > ITEM_QUALITY_NORMAL;
+                    bool shouldCheckGS = desiredQuality > ITEM_QUALITY_NORMAL;
 
-                        if (shouldCheckGS && gearScoreLimit != 0 &&
-                            CalcMixedGearScore(proto->ItemLevel, proto->Quality) > gearScoreLimit)
-                        {
-                            continue;
-                        }
-                        if (proto->Class != ITEM_CLASS_WEAPON && proto->Class != ITEM_CLASS_ARMOR)
-                            continue;
+                    if (shouldCheckGS && gearScoreLimit != 0 &&
+                        CalcMixedGearScore(proto->ItemLevel, proto->Quality) > gearScoreLimit)
+                    {
+                        continue;
+                    }
+                    if (proto->Class != ITEM_CLASS_WEAPON && proto->Class != ITEM_CLASS_ARMOR)
+                        continue;
 
-                        if (proto->Quality != desiredQuality)
-                            continue;
+                    if (proto->Quality != desiredQuality)
+                        continue;
 
-                        if (proto->Class == ITEM_CLASS_ARMOR &&
-                            (slot == EQUIPMENT_SLOT_HEAD || slot == EQUIPMENT_SLOT_SHOULDERS ||
-                             slot == EQUIPMENT_SLOT_CHEST || slot == EQUIPMENT_SLOT_WAIST ||
-                             slot == EQUIPMENT_SLOT_LEGS || slot == EQUIPMENT_SLOT_FEET ||
-                             slot == EQUIPMENT_SLOT_WRISTS || slot == EQUIPMENT_SLOT_HANDS) &&
-                            !CanEquipArmor(proto))
-                            continue;
+                    if (proto->Class == ITEM_CLASS_ARMOR &&
+                        (slot == EQUIPMENT_SLOT_HEAD || slot == EQUIPMENT_SLOT_SHOULDERS ||
+                         slot == EQUIPMENT_SLOT_CHEST || slot == EQUIPMENT_SLOT_WAIST ||
+                         slot == EQUIPMENT_SLOT_LEGS || slot == EQUIPMENT_SLOT_FEET ||
+                         slot == EQUIPMENT_SLOT_WRISTS || slot == EQUIPMENT_SLOT_HANDS) &&
+                        !CanEquipArmor(proto))
+                        continue;
 
-                        if (proto->Class == ITEM_CLASS_WEAPON && !CanEquipWeapon(proto))
-                            continue;
+                    if (proto->Class == ITEM_CLASS_WEAPON && !CanEquipWeapon(proto))
+                        continue;
 
-                        if (slot == EQUIPMENT_SLOT_OFFHAND && bot->getClass() == CLASS_ROGUE &&
-                            proto->Class != ITEM_CLASS_WEAPON)
-                            continue;
-                        items[slot].push_back(itemId);
-                    }
+                    if (slot == EQUIPMENT_SLOT_OFFHAND && bot->getClass() == CLASS_ROGUE &&
+                        proto->Class != ITEM_CLASS_WEAPON)
+                        continue;
+                    ids.push_back(itemId);
                 }
             }
-        } while (items[slot].size() < 25 && desiredQuality-- > ITEM_QUALITY_POOR);
+        }
+    } while (ids.size() < 25 && desiredQuality-- > ITEM_QUALITY_POOR);
 
-        std::vector<uint32>& ids = items[slot];
-        if (ids.empty())
-        {
+    candidates.reserve(ids.size());
+    for (uint32 itemId : ids)
+    {
+        float score = calculator.CalculateItem(itemId);
+        if (score > -1)
+            candidates.emplace_back(score, itemId);
+    }
+
+    // best first, equal scores stay in collection order
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](std::pair<float, uint32> const& a, std::pair<float, uint32> const& b)
+                     { return a.first > b.first; });
+}
+
+void PlayerbotFactory::ApplyEquipmentPlan(EquipmentPlan const& plan, bool incremental, bool second_chance)
+{
+    StatsWeightCalculator calculator(bot);
+    for (int32 slot : initSlotsOrder)
+    {
+        std::vector<std::pair<float, uint32>> const& candidates = plan.candidates[slot];
+        if (candidates.empty())
             continue;
-        }
+
+        Item* oldItem = bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot);
 
         float bestScoreForSlot = -1;
         uint32 bestItemForSlot = 0;
-        for (int index = 0; index < ids.size(); index++)
+        uint16 dest;
+        for (auto const& [score, newItemId] : candidates)
         {
-            uint32 newItemId = ids[index];
-
-            ItemTemplate const* proto = sObjectMgr->GetItemTemplate(newItemId);
-
-            float cur_score = calculator.CalculateItem(newItemId);
-            if (cur_score > bestScoreForSlot)
-            {
-                // delay heavy check to here
-                if (!CanEquipItem(proto))
-                    continue;
-                uint16 dest;
-                if (!CanEquipUnseenItem(slot, dest, newItemId))
-                    continue;
-                bestScoreForSlot = cur_score;
-                bestItemForSlot = newItemId;
-            }
+            // the heavy checks depend on the inventory, which changes as earlier slots are equipped
+            if (!CanEquipItem(sObjectMgr->GetItemTemplate(newItemId)))
+                continue;
+            if (!CanEquipUnseenItem(slot, dest, newItemId))
+                continue;
+            bestScoreForSlot = score;
+            bestItemForSlot = newItemId;
+            break;
         }
 
         if (bestItemForSlot == 0)
         {
             continue;
         }
-        uint16 dest;
-        if (!CanEquipUnseenItem(slot, dest, bestItemForSlot))
-        {
-            continue;
-        }
 
         if (incremental && oldItem)
         {
@@ -2177,35 +2219,22 @@ void PlayerbotFactory::InitEquipment(bool incremental, bool second_chance)
     {
         for (int32 slot : initSlotsOrder)
         {
-            if (slot == EQUIPMENT_SLOT_TABARD || slot == EQUIPMENT_SLOT_BODY)
-                continue;
-
-            if (level < 50 && (slot == EQUIPMENT_SLOT_TRINKET1 || slot == EQUIPMENT_SLOT_TRINKET2))
-                continue;
-
-            if (level < 30 && (slot == EQUIPMENT_SLOT_NECK || slot == EQUIPMENT_SLOT_HEAD))
-                continue;
-
-            if (level < 20 && (slot == EQUIPMENT_SLOT_FINGER1 || slot == EQUIPMENT_SLOT_FINGER2))
-                continue;
-
-            if (level < 5 && (slot != EQUIPMENT_SLOT_MAINHAND) && (slot != EQUIPMENT_SLOT_OFFHAND) &&
-                (slot != EQUIPMENT_SLOT_FEET) && (slot != EQUIPMENT_SLOT_LEGS) && (slot != EQUIPMENT_SLOT_CHEST) &&
-                (slot != EQUIPMENT_SLOT_RANGED))
+            if (!IsInitEquipmentSlot(slot))
                 continue;
 
             if (bot->GetItemByPos(INVENTORY_SLOT_BAG_0, slot) != nullptr)
                 bot->DestroyItem(INVENTORY_SLOT_BAG_0, slot, true);
 
-            std::vector<uint32>& ids = items[slot];
-            if (ids.empty())
+            std::vector<std::pair<float, uint32>> const& candidates = plan.candidates[slot];
+            if (candidates.empty())
                 continue;
 
+            // score again against the gear of the first round
             float bestScoreForSlot = -1;
             uint32 bestItemForSlot = 0;
-            for (int index = 0; index < ids.size(); index++)
+            for (auto const& candidate : candidates)
             {
-                uint32 newItemId = ids[index];
+                uint32 newItemId = candidate.second;
 
                 ItemTemplate const* proto = sObjectMgr->GetItemTemplate(newItemId);
 
@@ -3409,7 +3438,7 @@ void PlayerbotFactory::InitAmmo()
     if (!subClass)
         return;
 
-    std::vector<uint32> ammoEntryList = sRandomItemMgr.GetAmmo(level, subClass);
+    std::span<uint32 const> ammoEntryList = sRandomItemMgr.GetAmmo(level, subClass);
     uint32 entry = 0;
     for (uint32 tEntry : ammoEntryList)
     {
@@ -6,14 +6,17 @@
 #ifndef _PLAYERBOT_PLAYERBOTFACTORY_H
 #define _PLAYERBOT_PLAYERBOTFACTORY_H
 
+#include <array>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "InventoryAction.h"
 #include "Player.h"
 #include "PlayerbotAI.h"
 
 class Item;
+class StatsWeightCalculator;
 
 struct ItemTemplate;
 
@@ -148,11 +151,22 @@ private:
         uint32 weight;
     };
 
+    // Gear chosen for InitEquipment: the scored candidates of each slot, best first
+    struct EquipmentPlan
+    {
+        std::array<std::vector<std::pair<float, uint32>>, EQUIPMENT_SLOT_END> candidates;
+    };
+
     void Prepare();
     // void InitSecondEquipmentSet();
     // void InitEquipmentNew(bool incremental);
     bool CanEquipItem(ItemTemplate const* proto);
     bool CanEquipUnseenItem(uint8 slot, uint16& dest, uint32 item);
+    bool IsInitEquipmentSlot(uint8 slot) const;
+    void PlanEquipment(EquipmentPlan& plan);
+    void PlanEquipmentSlot(uint8 slot, StatsWeightCalculator& calculator,
+                           std::vector<std::pair<float, uint32>>& candidates);
+    void ApplyEquipmentPlan(EquipmentPlan const& plan, bool incremental, bool second_chance);
     static bool IsPrimaryTradeSkill(uint16 skillId);
     static bool IsGatheringTradeSkill(uint16 skillId);
     static bool IsCraftingTradeSkill(uint16 skillId);
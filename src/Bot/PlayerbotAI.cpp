@@ -5,6 +5,7 @@
 
 #include "PlayerbotAI.h"
 
+#include <algorithm>
 #include <cmath>
 #include <mutex>
 #include <sstream>
@@ -52,7 +53,6 @@
 #include "SpellInfo.h"
 #include "Transport.h"
 #include "Unit.h"
-#include "UpdateTime.h"
 #include "Vehicle.h"
 #include "../../../../src/server/scripts/Spells/spell_dk.cpp"
 
@@ -474,10 +474,15 @@ void PlayerbotAI::UpdateAIInternal([[maybe_unused]] uint32 elapsed, bool minimal
     if (!bot->GetMap())
         return; // instances are created and destroyed on demand
 
-    // kinda expensive call to make on every single updateAI, do we really need this information?
-    std::string const mapString = WorldPosition(bot).isOverworld() ? std::to_string(bot->GetMapId()) : "I";
-    PerfMonitorOperation* pmo =
-        sPerfMonitor.start(PERF_MON_TOTAL, "PlayerbotAI::UpdateAIInternal " + mapString);
+    // kinda expensive call to make on every single updateAI, so only build the name while profiling
+    std::string perfName;
+    if (sPlayerbotAIConfig.perfMonEnabled)
+    {
+        std::string const mapString = WorldPosition(bot).isOverworld() ? std::to_string(bot->GetMapId()) : "I";
+        perfName = "PlayerbotAI::UpdateAIInternal " + mapString;
+    }
+
+    PerfMonitorScope scope(PERF_MON_TOTAL, perfName);
 
     ExternalEventHelper helper(aiObjectContext);
 
@@ -544,9 +549,6 @@ void PlayerbotAI::UpdateAIInternal([[maybe_unused]] uint32 elapsed, bool minimal
     masterOutgoingPacketHandlers.Handle(helper);
 
     DoNextAction(minimal);
-
-    if (pmo)
-        pmo->finish();
 }
 
 void PlayerbotAI::HandleCommands()
@@ -3025,48 +3027,52 @@ bool IsRealAura(Player* bot, AuraEffect const* aurEff, Unit const* unit)
 bool PlayerbotAI::HasAura(std::string const name, Unit* unit, bool maxStack, bool checkIsOwner, int maxAuraAmount,
                           bool checkDuration)
 {
-    if (!IsValidUnit(unit))
-        return false;
+    return HasAura(PlayerbotSpellRepository::Instance().GetAuraNameId(name), unit, maxStack, checkIsOwner,
+                   maxAuraAmount, checkDuration);
+}
 
-    std::wstring wnamepart;
-    if (!Utf8toWStr(name, wnamepart))
+bool PlayerbotAI::HasAura(AuraNameId nameId, Unit* unit, bool maxStack, bool checkIsOwner, int maxAuraAmount,
+                          bool checkDuration)
+{
+    if (!IsValidUnit(unit))
         return false;
 
-    wstrToLower(wnamepart);
-
     int auraAmount = 0;
 
-    // Iterate through all aura types
-    for (uint32 auraType = SPELL_AURA_BIND_SIGHT; auraType < TOTAL_AURAS; auraType++)
+    // Only auras whose spell carries the requested name are looked at; every applied effect is
+    // counted, as the scan over all aura type lists did
+    if (nameId)
     {
-        Unit::AuraEffectList const& auras = unit->GetAuraEffectsByType((AuraType)auraType);
-        if (auras.empty())
-            continue;
-
-        // Iterate through each aura effect
-        for (AuraEffect const* aurEff : auras)
+        PlayerbotSpellRepository& spellRepository = PlayerbotSpellRepository::Instance();
+        for (auto const& [spellId, aurApp] : unit->GetAppliedAuras())
         {
-            if (!aurEff)
+            if (spellRepository.GetSpellAuraNameId(spellId) != nameId)
                 continue;
 
-            SpellInfo const* spellInfo = aurEff->GetSpellInfo();
-            if (!spellInfo)
-                continue;
+            Aura* aura = aurApp->GetBase();
+            for (uint8 effIndex = EFFECT_0; effIndex < MAX_SPELL_EFFECTS; ++effIndex)
+            {
+                if (!aurApp->HasEffect(effIndex))
+                    continue;
 
-            // Check if the aura name matches
-            std::string_view const auraName = spellInfo->SpellName[0];
-            if (auraName.empty() || auraName.length() != wnamepart.length() || !Utf8FitTo(auraName, wnamepart))
-                continue;
+                AuraEffect const* aurEff = aura->GetEffect(effIndex);
+                if (!aurEff || aurEff->GetAuraType() == SPELL_AURA_NONE)
+                    continue;
+
+                SpellInfo const* spellInfo = aurEff->GetSpellInfo();
+                if (!spellInfo)
+                    continue;
+
+                // Check if this is a valid aura for the bot
+                if (!IsRealAura(bot, aurEff, unit))
+                    continue;
 
-            // Check if this is a valid aura for the bot
-            if (IsRealAura(bot, aurEff, unit))
-            {
                 // Check caster if necessary
                 if (checkIsOwner && aurEff->GetCasterGUID() != bot->GetGUID())
                     continue;
 
                 // Check aura duration if necessary
-                if (checkDuration && aurEff->GetBase()->GetDuration() == -1)
+                if (checkDuration && aura->GetDuration() == -1)
                     continue;
 
                 // Count stacks and charges
@@ -3076,10 +3082,10 @@ bool PlayerbotAI::HasAura(std::string const name, Unit* unit, bool maxStack, boo
                 // Count the aura based on max stack and proc charges
                 if (maxStack)
                 {
-                    if (maxStackAmount && aurEff->GetBase()->GetStackAmount() >= maxStackAmount)
+                    if (maxStackAmount && aura->GetStackAmount() >= maxStackAmount)
                         auraAmount++;
 
-                    if (maxProcCharges && aurEff->GetBase()->GetCharges() >= maxProcCharges)
+                    if (maxProcCharges && aura->GetCharges() >= maxProcCharges)
                         auraAmount++;
                 }
                 else
@@ -3121,31 +3127,44 @@ bool PlayerbotAI::HasAura(uint32 spellId, Unit const* unit)
 
 Aura* PlayerbotAI::GetAura(std::string const name, Unit* unit, bool checkIsOwner, bool checkDuration, int checkStack)
 {
-    if (!IsValidUnit(unit))
-        return nullptr;
+    return GetAura(PlayerbotSpellRepository::Instance().GetAuraNameId(name), unit, checkIsOwner, checkDuration,
+                   checkStack);
+}
 
-    std::wstring wnamepart;
-    if (!Utf8toWStr(name, wnamepart))
+Aura* PlayerbotAI::GetAura(AuraNameId nameId, Unit* unit, bool checkIsOwner, bool checkDuration, int checkStack)
+{
+    if (!nameId || !IsValidUnit(unit))
         return nullptr;
 
-    wstrToLower(wnamepart);
-
-    for (uint32 auraType = SPELL_AURA_BIND_SIGHT; auraType < TOTAL_AURAS; ++auraType)
+    // Aura types of the auras carrying the name, the type lists of the unit are searched in type order below
+    PlayerbotSpellRepository& spellRepository = PlayerbotSpellRepository::Instance();
+    std::vector<AuraType> auraTypes;
+    for (auto const& [spellId, aurApp] : unit->GetAppliedAuras())
     {
-        Unit::AuraEffectList const& auras = unit->GetAuraEffectsByType((AuraType)auraType);
-        if (auras.empty())
+        if (spellRepository.GetSpellAuraNameId(spellId) != nameId)
             continue;
 
-        for (AuraEffect const* aurEff : auras)
+        Aura* aura = aurApp->GetBase();
+        for (uint8 effIndex = EFFECT_0; effIndex < MAX_SPELL_EFFECTS; ++effIndex)
         {
-            SpellInfo const* spellInfo = aurEff->GetSpellInfo();
-            if (!spellInfo)
+            if (!aurApp->HasEffect(effIndex))
                 continue;
 
-            std::string const& auraName = spellInfo->SpellName[0];
+            AuraEffect const* aurEff = aura->GetEffect(effIndex);
+            if (aurEff && aurEff->GetAuraType() != SPELL_AURA_NONE)
+                auraTypes.push_back(aurEff->GetAuraType());
+        }
+    }
 
-            // Directly skip if name mismatch (both length and content)
-            if (auraName.empty() || auraName.length() != wnamepart.length() || !Utf8FitTo(auraName, wnamepart))
+    std::sort(auraTypes.begin(), auraTypes.end());
+    auraTypes.erase(std::unique(auraTypes.begin(), auraTypes.end()), auraTypes.end());
+
+    // Returns the first match in aura type order, as the scan over all aura type lists did
+    for (AuraType auraType : auraTypes)
+    {
+        for (AuraEffect const* aurEff : unit->GetAuraEffectsByType(auraType))
+        {
+            if (spellRepository.GetSpellAuraNameId(aurEff->GetId()) != nameId)
                 continue;
 
             if (!IsRealAura(bot, aurEff, unit))
@@ -4572,49 +4591,16 @@ bool PlayerbotAI::AllowActive(ActivityType activityType)
     }
 
     // a real player is in the same zone (e.g. Elwynn Forest), same continent or within configured yard radius
-    // combined into a single loop to multiple iterations since this function is called so often
-    bool checkMap = sPlayerbotAIConfig.BotActiveAloneForceWhenInMap;
-    bool checkZone = sPlayerbotAIConfig.BotActiveAloneForceWhenInZone;
-    bool checkRadius = sPlayerbotAIConfig.BotActiveAloneForceWhenInRadius > 0;
-    if (checkMap || checkZone || checkRadius)
-    {
-        uint32 botMapId = bot->GetMapId();
-        uint32 botZoneId = checkZone ? bot->GetZoneId() : 0;
-        float sqRange = 0.0f;
-        WorldPosition botPos(bot);
-        if (checkRadius)
-        {
-            float range = static_cast<float>(sPlayerbotAIConfig.BotActiveAloneForceWhenInRadius);
-            sqRange = range * range;
-        }
-
-        for (auto& player : sRandomPlayerbotMgr.GetPlayers())
-        {
-            if (!player || player->GetMapId() != botMapId)
-                continue;
-
-            bool isGM = player->IsGameMaster();
-
-            // map check
-            if (checkMap && !(isGM && !player->IsVisible()))
-                return true;
-
-            // zone check
-            if (checkZone && !(isGM && !player->IsVisible()) && player->GetZoneId() == botZoneId)
-                return true;
+    PlayerPresenceIndex const& presence = sRandomPlayerbotMgr.GetPresenceIndex();
+    uint32 botMapId = bot->GetMapId();
+    if (sPlayerbotAIConfig.BotActiveAloneForceWhenInMap && presence.HasPlayerInMap(botMapId))
+        return true;
 
-            // radius check
-            if (checkRadius && (!isGM || player->isGMVisible()))
-            {
-                if (botPos.sqDistance(WorldPosition(player)) < sqRange)
-                    return true;
+    if (sPlayerbotAIConfig.BotActiveAloneForceWhenInZone && presence.HasPlayerInZone(botMapId, bot->GetZoneId()))
+        return true;
 
-                WorldObject* viewObj = player->GetViewpoint();
-                if (viewObj && viewObj != player && botPos.sqDistance(WorldPosition(viewObj)) < sqRange)
-                    return true;
-            }
-        }
-    }
+    if (sPlayerbotAIConfig.BotActiveAloneForceWhenInRadius > 0 && presence.HasPlayerInRadius(botMapId, *bot))
+        return true;
 
     // bot has a real player master (not another bot)
     if (GetMaster())
@@ -4672,20 +4658,8 @@ bool PlayerbotAI::AllowActive(ActivityType activityType)
         if (!bot->GetGUID())
             return false;
 
-        for (auto& player : sRandomPlayerbotMgr.GetPlayers())
-        {
-            if (!player || !player->GetSession() || !player->IsInWorld() || player->IsDuringRemoveFromWorld() ||
-                player->GetSession()->isLogingOut())
-                continue;
-
-            PlayerbotAI* playerAI = GET_PLAYERBOT_AI(player);
-            if (!playerAI || !playerAI->IsRealPlayer())
-                continue;
-
-            PlayerSocial* social = player->GetSocial();
-            if (social && social->HasFriend(bot->GetGUID()))
-                return true;
-        }
+        if (presence.IsFriendOfPlayer(bot->GetGUID()))
+            return true;
     }
 
     // pathfinding only runs for bots forced active by the rules above —
@@ -4699,17 +4673,20 @@ bool PlayerbotAI::AllowActive(ActivityType activityType)
     if (sPlayerbotAIConfig.botActiveAlone <= 0)
         return false;
 
-    // base threshold capped at 100
-    uint32 mod = sPlayerbotAIConfig.botActiveAlone > 100 ? 100 : sPlayerbotAIConfig.botActiveAlone;
-
-    // reduce threshold based on server tick time when SmartScale is enabled
+    // SmartScale: the governor admits a share of each priority class based on server tick time,
+    // the rotation below picks which bots of the class get it
     if (sPlayerbotAIConfig.botActiveAloneSmartScale &&
         bot->GetLevel() >= sPlayerbotAIConfig.botActiveAloneSmartScaleWhenMinLevel &&
         bot->GetLevel() <= sPlayerbotAIConfig.botActiveAloneSmartScaleWhenMaxLevel)
     {
-        mod = AutoScaleActivity(mod);
+        ActivityClass activityClass =
+            presence.HasPlayerInMap(botMapId) ? ACTIVITY_CLASS_NEAR_PLAYER : ACTIVITY_CLASS_IDLE;
+        return GetFixedBotNumber(1000) < sRandomPlayerbotMgr.AdmitActivityClass(activityClass);
     }
 
+    // base threshold capped at 100
+    uint32 mod = sPlayerbotAIConfig.botActiveAlone > 100 ? 100 : sPlayerbotAIConfig.botActiveAlone;
+
     // deterministic rotation — bot is active if its hash falls below the threshold
     uint32 ActivityNumber = GetFixedBotNumber(100);
     return ActivityNumber < mod;
@@ -4735,32 +4712,6 @@ bool PlayerbotAI::AllowActivity(ActivityType activityType, bool checkNow)
     return allowed;
 }
 
-uint32 PlayerbotAI::AutoScaleActivity(uint32 mod)
-{
-    // Current max server update time (ms), and the configured floor/ceiling values for bot scaling
-    uint32 maxDiff = sWorldUpdateTime.GetMaxUpdateTimeOfCurrentTable();
-    uint32 diffLimitFloor = sPlayerbotAIConfig.botActiveAloneSmartScaleDiffLimitfloor;
-    uint32 diffLimitCeiling = sPlayerbotAIConfig.botActiveAloneSmartScaleDiffLimitCeiling;
-
-    if (diffLimitCeiling <= diffLimitFloor)
-    {
-        // Perfrom binary decision if ceiling <= floor: Either all bots are active or none are
-        return (maxDiff > diffLimitCeiling) ? 0 : mod;
-    }
-
-    if (maxDiff > diffLimitCeiling)
-        return 0;
-
-    if (maxDiff <= diffLimitFloor)
-        return mod;
-
-    // Calculate lag progress from floor to ceiling (0 to 1)
-    double lagProgress = (maxDiff - diffLimitFloor) / (double)(diffLimitCeiling - diffLimitFloor);
-
-    // Apply the percentage of active bots (the complement of lag progress) to the mod value
-    return static_cast<uint32>(mod * (1 - lagProgress));
-}
-
 bool PlayerbotAI::IsOpposing(Player* player) { return IsOpposing(player->getRace(), bot->getRace()); }
 
 bool PlayerbotAI::IsOpposing(uint8 race1, uint8 race2)
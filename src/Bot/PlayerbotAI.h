@@ -19,6 +19,7 @@
 #include "PlayerbotAIBase.h"
 #include "PlayerbotAIConfig.h"
 #include "PlayerbotSecurity.h"
+#include "PlayerbotSpellRepository.h"
 #include "PlayerbotTextMgr.h"
 #include "SpellAuras.h"
 #include "Util.h"
@@ -499,6 +500,8 @@ public:
     virtual bool CastSpell(std::string const name, Unit* target, Item* itemTarget = nullptr);
     virtual bool HasAura(std::string const spellName, Unit* player, bool maxStack = false, bool checkIsOwner = false,
                          int maxAmount = -1, bool checkDuration = false);
+    bool HasAura(AuraNameId nameId, Unit* player, bool maxStack = false, bool checkIsOwner = false,
+                 int maxAmount = -1, bool checkDuration = false);
     virtual bool HasAnyAuraOf(Unit* player, ...);
 
     virtual bool IsInterruptableSpellCasting(Unit* player, std::string const spell);
@@ -512,6 +515,8 @@ public:
     bool HasAura(uint32 spellId, Unit const* player);
     Aura* GetAura(std::string const spellName, Unit* unit, bool checkIsOwner = false, bool checkDuration = false,
                   int checkStack = -1);
+    Aura* GetAura(AuraNameId nameId, Unit* unit, bool checkIsOwner = false, bool checkDuration = false,
+                  int checkStack = -1);
     bool CastSpell(uint32 spellId, Unit* target, Item* itemTarget = nullptr);
     bool CastSpell(uint32 spellId, float x, float y, float z, Item* itemTarget = nullptr);
     bool canDispel(SpellInfo const* spellInfo, uint32 dispelType);
@@ -550,7 +555,6 @@ public:
     bool HasPlayerNearby(float range = sPlayerbotAIConfig.reactDistance);
     bool AllowActive(ActivityType activityType);
     bool AllowActivity(ActivityType activityType = ALL_ACTIVITY, bool checkNow = false);
-    uint32 AutoScaleActivity(uint32 mod);
 
     // Check if player is safe to use.
     bool IsSafe(Player* player);
@@ -607,6 +611,10 @@ public:
     // Schedules a callback to run once after <delayMs> milliseconds.
     void AddTimedEvent(std::function<void()> callback, uint32 delayMs);
 
+    // Bumped when the bot learns or forgets a spell; spell lookups cache their results per version
+    uint32 GetSpellbookVersion() const { return spellbookVersion; }
+    void OnSpellbookChanged() { ++spellbookVersion; }
+
 private:
     static void _fillGearScoreData(Player* player, Item* item, std::vector<uint32>* gearScore, uint32& twoHandScore,
                                    bool mixed = false);
@@ -650,6 +658,7 @@ protected:
     Position jumpDestination = Position();
     uint32 nextTransportCheck = 0;
     bool spellInterruptRequested = false;
+    uint32 spellbookVersion = 1;
 };
 
 #endif
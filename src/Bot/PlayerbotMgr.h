@@ -9,10 +9,12 @@
 #include "ObjectGuid.h"
 #include "Player.h"
 #include "PlayerbotAIBase.h"
+#include "PlayerbotRegistry.h"
 
 class ChatHandler;
 class PlayerbotAI;
 class PlayerbotLoginQueryHolder;
+class PlayerbotMgr;
 class WorldPacket;
 
 typedef std::map<ObjectGuid, Player*> PlayerBotMap;
@@ -120,8 +122,9 @@ private:
     PlayerbotsMgr(PlayerbotsMgr&&) = delete;
     PlayerbotsMgr& operator=(PlayerbotsMgr&&) = delete;
 
-    std::unordered_map<ObjectGuid, PlayerbotAIBase*> _playerbotsAIMap;
-    std::unordered_map<ObjectGuid, PlayerbotAIBase*> _playerbotsMgrMap;
+    // Read from every map update thread, keyed by player guid counter
+    PlayerbotRegistry<PlayerbotAI> _playerbotsAI;
+    PlayerbotRegistry<PlayerbotMgr> _playerbotsMgr;
 };
 
 #define sPlayerbotsMgr PlayerbotsMgr::instance()
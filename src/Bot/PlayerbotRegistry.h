@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#ifndef _PLAYERBOT_PLAYERBOTREGISTRY_H
+#define _PLAYERBOT_PLAYERBOTREGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Maps player guid counters to one object per player.
+ *
+ * Lookups are wait-free: three acquire loads down a radix tree of 10/10/12 guid bits, no hashing and no
+ * lock, so map update threads can call Get concurrently with logins. Writers serialize on a mutex.
+ * Tree nodes are only freed with the registry, so a reader never touches freed table memory; the
+ * lifetime of the registered objects themselves is managed by their owners as before.
+ */
+template <class T>
+class PlayerbotRegistry
+{
+public:
+    PlayerbotRegistry() = default;
+
+    ~PlayerbotRegistry()
+    {
+        for (std::atomic<Branch*>& branch : root)
+            delete branch.load(std::memory_order_relaxed);
+    }
+
+    PlayerbotRegistry(PlayerbotRegistry const&) = delete;
+    PlayerbotRegistry& operator=(PlayerbotRegistry const&) = delete;
+
+    T* Get(uint32_t guid) const
+    {
+        Branch* branch = root[guid >> (LEAF_BITS + BRANCH_BITS)].load(std::memory_order_acquire);
+        if (!branch)
+            return nullptr;
+
+        Leaf* leaf = branch->leaves[(guid >> LEAF_BITS) & (BRANCH_SIZE - 1)].load(std::memory_order_acquire);
+        if (!leaf)
+            return nullptr;
+
+        return leaf->slots[guid & (LEAF_SIZE - 1)].load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Stores the object of a guid, replacing the previous one
+     * @return The replaced object, or nullptr
+     */
+    T* Set(uint32_t guid, T* value)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        std::atomic<T*>* slot = FindSlot(guid, value != nullptr);
+        if (!slot)
+            return nullptr;
+
+        return slot->exchange(value, std::memory_order_acq_rel);
+    }
+
+    T* Remove(uint32_t guid) { return Set(guid, nullptr); }
+
+private:
+    static constexpr uint32_t LEAF_BITS = 12;
+    static constexpr uint32_t BRANCH_BITS = 10;
+    static constexpr uint32_t ROOT_BITS = 32 - LEAF_BITS - BRANCH_BITS;
+    static constexpr uint32_t LEAF_SIZE = 1u << LEAF_BITS;
+    static constexpr uint32_t BRANCH_SIZE = 1u << BRANCH_BITS;
+
+    struct Leaf
+    {
+        std::array<std::atomic<T*>, LEAF_SIZE> slots{};
+    };
+
+    struct Branch
+    {
+        std::array<std::atomic<Leaf*>, BRANCH_SIZE> leaves{};
+
+        ~Branch()
+        {
+            for (std::atomic<Leaf*>& leaf : leaves)
+                delete leaf.load(std::memory_order_relaxed);
+        }
+    };
+
+    // Called with the lock held; new nodes are fully built before they are published
+    std::atomic<T*>* FindSlot(uint32_t guid, bool create)
+    {
+        std::atomic<Branch*>& branchRef = root[guid >> (LEAF_BITS + BRANCH_BITS)];
+        Branch* branch = branchRef.load(std::memory_order_relaxed);
+        if (!branch)
+        {
+            if (!create)
+                return nullptr;
+
+            branch = new Branch();
+            branchRef.store(branch, std::memory_order_release);
+        }
+
+        std::atomic<Leaf*>& leafRef = branch->leaves[(guid >> LEAF_BITS) & (BRANCH_SIZE - 1)];
+        Leaf* leaf = leafRef.load(std::memory_order_relaxed);
+        if (!leaf)
+        {
+            if (!create)
+                return nullptr;
+
+            leaf = new Leaf();
+            leafRef.store(leaf, std::memory_order_release);
+        }
+
+        return &leaf->slots[guid & (LEAF_SIZE - 1)];
+    }
+
+    std::array<std::atomic<Branch*>, 1u << ROOT_BITS> root{};
+    std::mutex lock;
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#include "RandomBotRoster.h"
+
+#include <algorithm>
+
+void RandomBotRoster::Add(uint32 bot, uint32 now)
+{
+    if (Contains(bot))
+        return;
+
+    slots.emplace(bot, entries.size());
+    entries.push_back({bot, now});
+
+    schedule.emplace_back(now, bot);
+    std::push_heap(schedule.begin(), schedule.end(), Later);
+}
+
+void RandomBotRoster::Remove(uint32 bot)
+{
+    auto found = slots.find(bot);
+    if (found == slots.end())
+        return;
+
+    // move the last bot into the freed slot, its heap entries stay valid as they are keyed by bot
+    uint32 slot = found->second;
+    slots.erase(found);
+
+    if (slot != entries.size() - 1)
+    {
+        entries[slot] = entries.back();
+        slots[entries[slot].bot] = slot;
+    }
+
+    entries.pop_back();
+}
+
+void RandomBotRoster::Clear()
+{
+    entries.clear();
+    slots.clear();
+    schedule.clear();
+    cursor = 0;
+}
+
+uint32 RandomBotRoster::Next()
+{
+    if (entries.empty())
+        return 0;
+
+    if (cursor >= entries.size())
+        cursor = 0;
+
+    return entries[cursor++].bot;
+}
+
+void RandomBotRoster::Schedule(uint32 bot, uint32 due)
+{
+    auto found = slots.find(bot);
+    if (found == slots.end())
+        return;
+
+    Entry& entry = entries[found->second];
+    if (entry.due == due)
+        return;
+
+    entry.due = due;
+    schedule.emplace_back(due, bot);
+    std::push_heap(schedule.begin(), schedule.end(), Later);
+
+    Compact();
+}
+
+bool RandomBotRoster::PopDue(uint32 now, uint32& bot)
+{
+    while (!schedule.empty() && schedule.front().first <= now)
+    {
+        std::pair<uint32, uint32> next = schedule.front();
+        std::pop_heap(schedule.begin(), schedule.end(), Later);
+        schedule.pop_back();
+
+        // skip bots that left the roster or were rescheduled since this entry was pushed
+        auto found = slots.find(next.second);
+        if (found == slots.end() || entries[found->second].due != next.first)
+            continue;
+
+        // unscheduled until the caller schedules it again
+        entries[found->second].due = UNSCHEDULED;
+        bot = next.second;
+        return true;
+    }
+
+    return false;
+}
+
+void RandomBotRoster::Compact()
+{
+    // stale entries only cost memory until popped, rebuild once they dominate the heap
+    if (schedule.size() < entries.size() * 2 + 64)
+        return;
+
+    schedule.clear();
+    for (Entry const& entry : entries)
+        schedule.emplace_back(entry.due, entry.bot);
+
+    std::make_heap(schedule.begin(), schedule.end(), Later);
+}
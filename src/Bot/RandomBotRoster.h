@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#ifndef _PLAYERBOT_RANDOMBOTROSTER_H
+#define _PLAYERBOT_RANDOMBOTROSTER_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Define.h"
+
+/**
+ * @brief The random bots selected to be online, with a login cursor and an update schedule
+ *
+ * Bots are kept densely in a vector with an id -> slot index, so membership checks and removal are O(1)
+ * and the login pass walks the roster round-robin from where the previous pass stopped.
+ *
+ * Each bot has a due time (seconds), and a min-heap orders the bots by it so the update pass only visits
+ * bots whose next event is due. Rescheduling pushes a new heap entry; the old one is recognised as stale
+ * when popped because it no longer matches the bot's due time.
+ */
+class RandomBotRoster
+{
+public:
+    bool Contains(uint32 bot) const { return slots.find(bot) != slots.end(); }
+    uint32 Size() const { return entries.size(); }
+    bool Empty() const { return entries.empty(); }
+
+    /**
+     * @brief Adds a bot, due immediately
+     */
+    void Add(uint32 bot, uint32 now);
+    void Remove(uint32 bot);
+    void Clear();
+
+    /**
+     * @brief Returns the bot under the login cursor and advances the cursor
+     */
+    uint32 Next();
+
+    /**
+     * @brief Sets the time the bot is next due for an update, 0xFFFFFFFF for never
+     */
+    void Schedule(uint32 bot, uint32 due);
+
+    /**
+     * @brief Removes the earliest scheduled bot if it is due, the bot stays unscheduled until Schedule
+     * @return false if no bot is due at now
+     */
+    bool PopDue(uint32 now, uint32& bot);
+
+private:
+    static constexpr uint32 UNSCHEDULED = 0xFFFFFFFF;
+
+    struct Entry
+    {
+        uint32 bot;
+        uint32 due;
+    };
+
+    // (due, bot), earliest first
+    static bool Later(std::pair<uint32, uint32> const& a, std::pair<uint32, uint32> const& b)
+    {
+        return a.first > b.first;
+    }
+
+    void Compact();
+
+    std::vector<Entry> entries;
+    std::unordered_map<uint32, uint32> slots;  // bot -> index in entries
+    std::vector<std::pair<uint32, uint32>> schedule;
+    uint32 cursor = 0;
+};
+
+#endif
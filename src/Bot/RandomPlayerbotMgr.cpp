@@ -9,9 +9,11 @@
 
 #include <algorithm>
 #include <boost/thread/thread.hpp>
+#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include <iomanip>
+#include <limits>
 #include <random>
 
 #include "AiFactory.h"
@@ -41,8 +43,10 @@
 #include "RandomPlayerbotFactory.h"
 #include "ServerFacade.h"
 #include "SharedDefines.h"
+#include "SocialMgr.h"
 #include "TravelMgr.h"
 #include "Unit.h"
+#include "UpdateTime.h"
 #include "World.h"
 #include "Cell.h"
 #include "GridNotifiers.h"
@@ -285,6 +289,17 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed, bool /*minimal*/)
 
     totalPmo = sPerfMonitor.start(PERF_MON_TOTAL, "RandomPlayerbotMgr::FullTick");
 
+    // Map threads only mark events dirty, the write back always starts here on the world thread
+    bool flushEvents = false;
+    {
+        std::lock_guard<std::recursive_mutex> guard(eventLock);
+        flushEvents = eventFlushRequested || (pendingEventCount && NowSeconds() - oldestDirtyEventTime >=
+                                                                       sPlayerbotAIConfig.randomBotEventFlushInterval);
+    }
+
+    if (flushEvents)
+        FlushEventValues();
+
     if (!sPlayerbotAIConfig.randomBotAutologin || !sPlayerbotAIConfig.enabled)
         return;
 
@@ -308,8 +323,7 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed, bool /*minimal*/)
     }
 
     GetBots();
-    std::list<uint32> availableBots = currentBots;
-    uint32 availableBotCount = availableBots.size();
+    uint32 availableBotCount = botRoster.Size();
     uint32 onlineBotCount = playerBots.size();
 
     uint32 onlineBotFocus = 75;
@@ -409,11 +423,14 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed, bool /*minimal*/)
             : 0;
     uint32 loginBots = std::min(sPlayerbotAIConfig.randomBotsPerInterval - updateBots, maxNewBots);
 
-    if (!availableBots.empty())
+    if (!botRoster.Empty())
     {
-        // Update bots
-        for (auto bot : availableBots)
+        // Update the online bots whose "update" or "add" event is due, earliest first
+        uint32 now = NowSeconds();
+        uint32 bot = 0;
+        while (updateBots && botRoster.PopDue(now, bot))
         {
+            // offline bots are rescheduled by the login pass once they are added
             if (!GetPlayerBot(bot))
                 continue;
 
@@ -422,8 +439,9 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed, bool /*minimal*/)
                 updateBots--;
             }
 
-            if (!updateBots)
-                break;
+            // bots skipped while grouped or in flight are retried next interval
+            if (botRoster.Contains(bot))
+                botRoster.Schedule(bot, std::max(GetBotDueTime(bot), now + 1));
         }
 
         if (loginBots && botLoading.empty())
@@ -433,9 +451,10 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed, bool /*minimal*/)
 
             LOG_DEBUG("playerbots", "{} new bots prepared to login", loginBots);
 
-            // Log in bots
-            for (auto bot : availableBots)
+            // Log in bots, continuing from where the previous pass stopped
+            for (uint32 visited = 0, count = botRoster.Size(); loginBots && visited < count; ++visited)
             {
+                bot = botRoster.Next();
                 if (GetPlayerBot(bot))
                     continue;
 
@@ -443,9 +462,6 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed, bool /*minimal*/)
                 {
                     loginBots--;
                 }
-
-                if (!loginBots)
-                    break;
             }
 
             DelayLoginBotsTimer = 0;
@@ -461,25 +477,70 @@ void RandomPlayerbotMgr::UpdateAIInternal(uint32 elapsed, bool /*minimal*/)
     }
 }
 
-// void RandomPlayerbotMgr::ScaleBotActivity()
-//{
-//     float activityPercentage = getActivityPercentage();
-//
-//     // if (activityPercentage >= 100.0f || activityPercentage <= 0.0f) pid.reset(); //Stop integer buildup during
-//     // max/min activity
-//
-//     //    % increase/decrease                   wanted diff                                         , avg diff
-//     float activityPercentageMod = pid.calculate(
-//         sRandomPlayerbotMgr.GetPlayers().empty() ? sPlayerbotAIConfig.diffEmpty :
-//         sPlayerbotAIConfig.diffWithPlayer, sWorldUpdateTime.GetAverageUpdateTime());
-//
-//     activityPercentage = activityPercentageMod + 50;
-//
-//     // Cap the percentage between 0 and 100.
-//     activityPercentage = std::max(0.0f, std::min(100.0f, activityPercentage));
-//
-//     setActivityPercentage(activityPercentage);
-// }
+void RandomPlayerbotMgr::UpdateActivityGovernor(uint32 diff)
+{
+    activityGovernorTimer += diff;
+    if (activityGovernorTimer < 1000)
+        return;
+
+    activityGovernorTimer = 0;
+
+    float budget = activityBudget.load(std::memory_order_relaxed);
+    if (!sPlayerbotAIConfig.botActiveAloneSmartScale)
+    {
+        budget = 1.0f;
+        pid.reset();
+    }
+    else
+    {
+        // the tail, not the mean, is what players notice as lag
+        uint32 tickTime = sWorldUpdateTime.GetPercentile(95);
+        if (tickTime >= sPlayerbotAIConfig.botActiveAloneSmartScaleDiffLimitCeiling)
+        {
+            budget = 0.0f;
+            pid.reset();
+        }
+        else
+        {
+            pid.adjust(sPlayerbotAIConfig.botActiveAloneSmartScaleKp, sPlayerbotAIConfig.botActiveAloneSmartScaleKi,
+                       sPlayerbotAIConfig.botActiveAloneSmartScaleKd);
+            budget += pid.calculate(sPlayerbotAIConfig.botActiveAloneSmartScaleDiffLimitfloor, tickTime);
+            budget = std::max(0.0f, std::min(1.0f, budget));
+        }
+    }
+
+    activityBudget.store(budget, std::memory_order_relaxed);
+
+    // bots re-check every few seconds, so smooth the per second reports over a few samples
+    float totalLoad = 0.0f;
+    for (uint32 i = 0; i < MAX_ACTIVITY_CLASSES; ++i)
+    {
+        activityClassLoad[i] =
+            activityClassLoad[i] * 0.8f + activityClassReports[i].exchange(0, std::memory_order_relaxed);
+        totalLoad += activityClassLoad[i];
+    }
+
+    // hand out BotActiveAlone% of the throttled bots, scaled by the budget, highest class first
+    uint32 mod = std::min<uint32>(sPlayerbotAIConfig.botActiveAlone, 100);
+    float admitted = totalLoad * budget * mod / 100.0f;
+    for (uint32 i = 0; i < MAX_ACTIVITY_CLASSES; ++i)
+    {
+        float share = 0.0f;
+        if (activityClassLoad[i] > 0.0f)
+            share = std::min(1.0f, admitted / activityClassLoad[i]);
+        else if (totalLoad <= 0.0f)
+            share = budget * mod / 100.0f;
+
+        admitted = std::max(0.0f, admitted - activityClassLoad[i]);
+        activityClassShares[i].store(static_cast<uint32>(share * 1000.0f), std::memory_order_relaxed);
+    }
+}
+
+uint32 RandomPlayerbotMgr::AdmitActivityClass(ActivityClass activityClass)
+{
+    activityClassReports[activityClass].fetch_add(1, std::memory_order_relaxed);
+    return activityClassShares[activityClass].load(std::memory_order_relaxed);
+}
 
 // Assigns accounts as RNDbot accounts (type 1) based on MaxRandomBots and EnablePeriodicOnlineOffline and its ratio,
 // and assigns accounts as AddClass accounts (type 2) based AddClassAccountPoolSize. Type 1 and 2 assignments are
@@ -639,10 +700,10 @@ uint32 RandomPlayerbotMgr::AddRandomBots()
     uint32 maxAllowedBotCount = GetEventValue(0, "bot_count");
     static time_t missingBotsTimer = 0;
 
-    if (currentBots.size() < maxAllowedBotCount)
+    if (botRoster.Size() < maxAllowedBotCount)
     {
         // Calculate how many bots to add
-        maxAllowedBotCount -= currentBots.size();
+        maxAllowedBotCount -= botRoster.Size();
         maxAllowedBotCount = std::min(sPlayerbotAIConfig.randomBotsPerInterval, maxAllowedBotCount);
 
         // Single RNG instance for all shuffling
@@ -737,7 +798,7 @@ uint32 RandomPlayerbotMgr::AddRandomBots()
             if (GetEventValue(charInfo.guid, "add") ||
                 GetEventValue(charInfo.guid, "logout") ||
                 GetPlayerBot(charInfo.guid) ||
-                std::find(currentBots.begin(), currentBots.end(), charInfo.guid) != currentBots.end() ||
+                botRoster.Contains(charInfo.guid) ||
                 (sPlayerbotAIConfig.disableDeathKnightLogin && charInfo.rClass == CLASS_DEATH_KNIGHT))
             {
                 return false;
@@ -750,7 +811,7 @@ uint32 RandomPlayerbotMgr::AddRandomBots()
 
             SetEventValue(charInfo.guid, "add", 1, add_time);
             SetEventValue(charInfo.guid, "logout", 0, 0);
-            currentBots.push_back(charInfo.guid);
+            botRoster.Add(charInfo.guid, NowSeconds());
 
             return true;
         };
@@ -814,7 +875,7 @@ uint32 RandomPlayerbotMgr::AddRandomBots()
         missingBotsTimer = 0;           // Reset timer if there's enough bots
     }
 
-    return currentBots.size();
+    return botRoster.Size();
 }
 
 void RandomPlayerbotMgr::LoadBattleMastersCache()
@@ -1349,7 +1410,7 @@ bool RandomPlayerbotMgr::ProcessBot(uint32 bot)
                 LOG_DEBUG("playerbots", "Bot #{}: log out", bot);
 
             SetEventValue(bot, "add", 0, 0);
-            currentBots.remove(bot);
+            botRoster.Remove(bot);
 
             if (player)
                 LogoutPlayerBot(botGUID);
@@ -1432,7 +1493,7 @@ bool RandomPlayerbotMgr::ProcessBot(uint32 bot)
         LOG_DEBUG("playerbots", "Bot #{} {}:{} <{}>: log out", bot, IsAlliance(player->getRace()) ? "A" : "H",
                   player->GetLevel(), player->GetName().c_str());
         LogoutPlayerBot(botGUID);
-        currentBots.remove(bot);
+        botRoster.Remove(bot);
         SetEventValue(bot, "logout", 1,
                       urand(sPlayerbotAIConfig.minRandomBotInWorldTime, sPlayerbotAIConfig.maxRandomBotInWorldTime));
         return true;
@@ -1761,6 +1822,8 @@ void RandomPlayerbotMgr::Init()
         sRandomPlayerbotMgr.LoadBattleMastersCache();
 
     PlayerbotsDatabase.Execute("DELETE FROM playerbots_random_bots WHERE event = 'add'");
+
+    LoadEventCache();
 }
 
 void RandomPlayerbotMgr::RandomTeleportForLevel(Player* bot)
@@ -1952,17 +2015,9 @@ void RandomPlayerbotMgr::RandomizeFirst(Player* bot)
     uint32 inworldTime =
         urand(sPlayerbotAIConfig.minRandomBotInWorldTime, sPlayerbotAIConfig.maxRandomBotInWorldTime);
 
-    PlayerbotsDatabasePreparedStatement* stmt = PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_UPD_RANDOM_BOTS);
-    stmt->SetData(0, randomTime);
-    stmt->SetData(1, "bot_delete");
-    stmt->SetData(2, bot->GetGUID().GetCounter());
-    PlayerbotsDatabase.Execute(stmt);
-
-    stmt = PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_UPD_RANDOM_BOTS);
-    stmt->SetData(0, inworldTime);
-    stmt->SetData(1, "logout");
-    stmt->SetData(2, bot->GetGUID().GetCounter());
-    PlayerbotsDatabase.Execute(stmt);
+    // through the cache, a direct table update would be overwritten by the next flush of these events
+    SetEventValidIn(bot->GetGUID().GetCounter(), "bot_delete", randomTime);
+    SetEventValidIn(bot->GetGUID().GetCounter(), "logout", inworldTime);
 
     // teleport to a random inn for bot level
     botAI->Reset(true);
@@ -1993,17 +2048,9 @@ void RandomPlayerbotMgr::RandomizeMin(Player* bot)
     uint32 inworldTime =
         urand(sPlayerbotAIConfig.minRandomBotInWorldTime, sPlayerbotAIConfig.maxRandomBotInWorldTime);
 
-    PlayerbotsDatabasePreparedStatement* stmt = PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_UPD_RANDOM_BOTS);
-    stmt->SetData(0, randomTime);
-    stmt->SetData(1, "bot_delete");
-    stmt->SetData(2, bot->GetGUID().GetCounter());
-    PlayerbotsDatabase.Execute(stmt);
-
-    stmt = PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_UPD_RANDOM_BOTS);
-    stmt->SetData(0, inworldTime);
-    stmt->SetData(1, "logout");
-    stmt->SetData(2, bot->GetGUID().GetCounter());
-    PlayerbotsDatabase.Execute(stmt);
+    // through the cache, a direct table update would be overwritten by the next flush of these events
+    SetEventValidIn(bot->GetGUID().GetCounter(), "bot_delete", randomTime);
+    SetEventValidIn(bot->GetGUID().GetCounter(), "logout", inworldTime);
 
     // teleport to a random inn for bot level
     botAI->Reset(true);
@@ -2114,14 +2161,12 @@ bool RandomPlayerbotMgr::IsRandomBot(Player* bot)
 
 bool RandomPlayerbotMgr::IsRandomBot(ObjectGuid::LowType bot)
 {
-    ObjectGuid guid = ObjectGuid::Create<HighGuid::Player>(bot);
-    if (!sPlayerbotAIConfig.IsInRandomAccountList(sCharacterCache->GetCharacterAccountIdByGuid(guid)))
+    // roster membership is a hash lookup, check it before the character cache
+    if (!botRoster.Contains(bot))
         return false;
 
-    if (std::find(currentBots.begin(), currentBots.end(), bot) != currentBots.end())
-        return true;
-
-    return false;
+    ObjectGuid guid = ObjectGuid::Create<HighGuid::Player>(bot);
+    return sPlayerbotAIConfig.IsInRandomAccountList(sCharacterCache->GetCharacterAccountIdByGuid(guid));
 }
 
 bool RandomPlayerbotMgr::IsAddclassBot(Player* bot)
@@ -2171,60 +2216,148 @@ bool RandomPlayerbotMgr::IsAddclassBot(ObjectGuid::LowType bot)
 
 void RandomPlayerbotMgr::GetBots()
 {
-    if (!currentBots.empty())
+    if (!botRoster.Empty())
         return;
 
-    PlayerbotsDatabasePreparedStatement* stmt =
-        PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_SEL_RANDOM_BOTS_BY_OWNER_AND_EVENT);
-    stmt->SetData(0, 0);
-    stmt->SetData(1, "add");
     uint32 maxAllowedBotCount = GetEventValue(0, "bot_count");
-    if (PreparedQueryResult result = PlayerbotsDatabase.Query(stmt))
+    for (uint32 bot : GetEventBots("add"))
+    {
+        if (botRoster.Size() >= maxAllowedBotCount)
+            break;
+
+        botRoster.Add(bot, NowSeconds());
+    }
+}
+
+std::vector<uint32> RandomPlayerbotMgr::GetBgBots(uint32 bracket)
+{
+    // if (!currentBgBots.empty()) return currentBgBots;
+
+    return GetEventBots("bg", bracket);
+}
+
+std::vector<uint32> RandomPlayerbotMgr::GetEventBots(std::string const& event, uint32 value)
+{
+    std::vector<uint32> bots;
+
+    {
+        std::lock_guard<std::recursive_mutex> guard(eventLock);
+        if (eventCachePreloaded)
+        {
+            for (auto const& [bot, cache] : eventCache)
+            {
+                // also drops the event once expired
+                CachedEvent const* e = FindEvent(bot, event);
+                if (e && (!value || e->value == value))
+                    bots.push_back(bot);
+            }
+
+            std::sort(bots.begin(), bots.end());
+            return bots;
+        }
+    }
+
+    // Before Init preloads the cache only the table knows every bot, write the pending rows first
+    FlushEventValues(true);
+
+    std::string escapedEvent = event;
+    PlayerbotsDatabase.EscapeString(escapedEvent);
+    std::string const valueFilter = value ? " AND value = " + std::to_string(value) : "";
+    if (QueryResult result = PlayerbotsDatabase.Query(
+            "SELECT DISTINCT bot FROM playerbots_random_bots WHERE owner = 0 AND event = '{}'{} ORDER BY bot",
+            escapedEvent, valueFilter))
     {
         do
         {
             Field* fields = result->Fetch();
-            uint32 bot = fields[0].Get<uint32>();
-            if (GetEventValue(bot, "add"))
-                currentBots.push_back(bot);
-
-            if (currentBots.size() >= maxAllowedBotCount)
-                break;
+            bots.push_back(fields[0].Get<uint32>());
         } while (result->NextRow());
     }
+
+    return bots;
 }
 
-std::vector<uint32> RandomPlayerbotMgr::GetBgBots(uint32 bracket)
+uint32 RandomPlayerbotMgr::InternEvent(std::string const& event)
 {
-    // if (!currentBgBots.empty()) return currentBgBots;
+    // Map threads intern new names while the world thread resolves ids in FlushEventValues
+    std::lock_guard<std::recursive_mutex> guard(eventLock);
 
-    std::vector<uint32> BgBots;
+    auto found = eventIds.find(event);
+    if (found != eventIds.end())
+        return found->second;
 
-    PlayerbotsDatabasePreparedStatement* stmt =
-        PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_SEL_RANDOM_BOTS_BY_EVENT_AND_VALUE);
-    stmt->SetData(0, "bg");
-    stmt->SetData(1, bracket);
-    if (PreparedQueryResult result = PlayerbotsDatabase.Query(stmt))
+    uint32 eventId = eventNames.size();
+    eventNames.push_back(event);
+    eventIds.emplace(event, eventId);
+    return eventId;
+}
+
+void RandomPlayerbotMgr::LoadEventCache()
+{
+    LOG_INFO("server.loading", "Loading random bot events...");
+    uint32 oldMSTime = getMSTime();
+
+    std::lock_guard<std::recursive_mutex> guard(eventLock);
+    eventCache.clear();
+
+    // Init has just queued the removal of the 'add' events, skip them in case it has not run yet
+    uint32 count = 0;
+    if (QueryResult result = PlayerbotsDatabase.Query(
+            "SELECT bot, event, value, time, validIn, data FROM playerbots_random_bots "
+            "WHERE owner = 0 AND event <> 'add'"))
     {
         do
         {
             Field* fields = result->Fetch();
-            uint32 bot = fields[0].Get<uint32>();
-            BgBots.push_back(bot);
+            BotEventCache& cache = eventCache[fields[0].Get<uint32>()];
+
+            CachedEvent& e = cache.FindOrAdd(InternEvent(fields[1].Get<std::string>()));
+            e.value = fields[2].Get<uint32>();
+            e.lastChangeTime = fields[3].Get<uint32>();
+            e.validIn = fields[4].Get<uint32>();
+            e.data = fields[5].Get<std::string>();
+            ++count;
         } while (result->NextRow());
     }
 
-    return BgBots;
+    size_t memory = eventCache.bucket_count() * sizeof(void*);
+    for (auto& [bot, cache] : eventCache)
+    {
+        cache.loaded = true;
+        cache.events.shrink_to_fit();
+
+        memory += sizeof(std::pair<uint32 const, BotEventCache>) + 2 * sizeof(void*);
+        memory += cache.events.capacity() * sizeof(CachedEvent);
+        for (CachedEvent const& e : cache.events)
+            if (e.data.capacity() >= sizeof(std::string))
+                memory += e.data.capacity() + 1;
+    }
+
+    eventCachePreloaded = true;
+
+    LOG_INFO("server.loading", "{} random bot events of {} bots loaded in {} ms (~{} KB)", count,
+             eventCache.size(), GetMSTimeDiffToNow(oldMSTime), memory / 1024);
 }
 
 CachedEvent* RandomPlayerbotMgr::FindEvent(uint32 bot, std::string const& event)
 {
-    BotEventCache& cache = eventCache[bot];
+    BotEventCache* cache = nullptr;
+    if (eventCachePreloaded)
+    {
+        // bots without stored events have no cache entry, don't create one per lookup
+        auto found = eventCache.find(bot);
+        if (found == eventCache.end())
+            return nullptr;
+
+        cache = &found->second;
+    }
+    else
+        cache = &eventCache[bot];
 
     // Load once
-    if (!cache.loaded)
+    if (!cache->loaded)
     {
-        cache.events.clear();
+        cache->events.clear();
 
         PlayerbotsDatabasePreparedStatement* stmt =
             PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_SEL_RANDOM_BOTS_BY_OWNER_AND_BOT);
@@ -2237,37 +2370,36 @@ CachedEvent* RandomPlayerbotMgr::FindEvent(uint32 bot, std::string const& event)
             {
                 Field* fields = result->Fetch();
 
-                CachedEvent e;
+                CachedEvent& e = cache->FindOrAdd(InternEvent(fields[0].Get<std::string>()));
                 e.value = fields[1].Get<uint32>();
                 e.lastChangeTime = fields[2].Get<uint32>();
                 e.validIn = fields[3].Get<uint32>();
                 e.data = fields[4].Get<std::string>();
-
-                cache.events.emplace(fields[0].Get<std::string>(), std::move(e));
             } while (result->NextRow());
         }
 
-        cache.loaded = true;
+        cache->loaded = true;
     }
 
-    auto it = cache.events.find(event);
-    if (it == cache.events.end())
+    uint32 eventId = InternEvent(event);
+    CachedEvent* e = cache->Find(eventId);
+    if (!e)
         return nullptr;
 
-    CachedEvent& e = it->second;
-
     // remove expired events
-    if (e.validIn && (NowSeconds() - e.lastChangeTime) >= e.validIn && event != "specNo" && event != "specLink")
+    if (e->validIn && (NowSeconds() - e->lastChangeTime) >= e->validIn && event != "specNo" && event != "specLink")
     {
-        cache.events.erase(it);
+        cache->Erase(eventId);
         return nullptr;
     }
 
-    return &e;
+    return e;
 }
 
 uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, std::string const& event)
 {
+    std::lock_guard<std::recursive_mutex> guard(eventLock);
+
     if (CachedEvent* e = FindEvent(bot, event))
         return e->value;
 
@@ -2276,63 +2408,191 @@ uint32 RandomPlayerbotMgr::GetEventValue(uint32 bot, std::string const& event)
 
 std::string RandomPlayerbotMgr::GetEventData(uint32 bot, std::string const& event)
 {
+    std::lock_guard<std::recursive_mutex> guard(eventLock);
+
     if (CachedEvent* e = FindEvent(bot, event))
         return e->data;
 
     return "";
 }
 
-uint32 RandomPlayerbotMgr::SetEventValue(uint32 bot, std::string const& event, uint32 value, uint32 validIn,
-                                         std::string const& data)
+uint32 RandomPlayerbotMgr::GetBotDueTime(uint32 bot)
 {
-    PlayerbotsDatabaseTransaction trans = PlayerbotsDatabase.BeginTransaction();
+    std::lock_guard<std::recursive_mutex> guard(eventLock);
 
-    PlayerbotsDatabasePreparedStatement* stmt =
-        PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_DEL_RANDOM_BOTS_BY_OWNER_AND_EVENT);
-    stmt->SetData(0, 0);
-    stmt->SetData(1, bot);
-    stmt->SetData(2, event.c_str());
-    trans->Append(stmt);
+    uint32 now = NowSeconds();
+    uint32 due = std::numeric_limits<uint32>::max();
 
-    if (value)
+    // a missing (or just expired) event is due now, one without expiry never
+    for (char const* event : {"update", "add"})
     {
-        stmt = PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_INS_RANDOM_BOTS);
-        stmt->SetData(0, 0);
-        stmt->SetData(1, bot);
-        stmt->SetData(2, NowSeconds());
-        stmt->SetData(3, validIn);
-        stmt->SetData(4, event.c_str());
-        stmt->SetData(5, value);
+        CachedEvent* e = FindEvent(bot, event);
+        if (!e)
+            return now;
 
-        if (!data.empty())
-            stmt->SetData(6, data.c_str());
-        else
-            stmt->SetData(6);  // NULL
-
-        trans->Append(stmt);
+        if (e->validIn)
+            due = std::min(due, e->lastChangeTime + e->validIn);
     }
 
-    PlayerbotsDatabase.CommitTransaction(trans);
+    return due;
+}
 
-    // Update in-memory cache
+uint32 RandomPlayerbotMgr::SetEventValue(uint32 bot, std::string const& event, uint32 value, uint32 validIn,
+                                         std::string const& data)
+{
+    // The cache is authoritative, FlushEventValues writes the change back to the database
+    std::lock_guard<std::recursive_mutex> guard(eventLock);
     BotEventCache& cache = eventCache[bot];
     cache.loaded = true;
 
+    uint32 eventId = InternEvent(event);
+    MarkEventDirty(bot, eventId);
+
     if (!value)
     {
-        cache.events.erase(event);
-        return 0;
+        cache.Erase(eventId);
+    }
+    else
+    {
+        CachedEvent& e = cache.FindOrAdd(eventId);
+        e.value = value;
+        e.lastChangeTime = NowSeconds();
+        e.validIn = validIn;
+        e.data = data;
     }
 
-    CachedEvent& e = cache.events[event];  // create-on-write is OK here
-    e.value = value;
-    e.lastChangeTime = NowSeconds();
-    e.validIn = validIn;
-    e.data = data;
+    // "add" and "update" expiries decide when a bot is next due in the update pass
+    if ((event == "update" || event == "add") && botRoster.Contains(bot))
+        botRoster.Schedule(bot, GetBotDueTime(bot));
 
     return value;
 }
 
+void RandomPlayerbotMgr::SetEventValidIn(uint32 bot, std::string const& event, uint32 validIn)
+{
+    std::lock_guard<std::recursive_mutex> guard(eventLock);
+
+    if (CachedEvent* e = FindEvent(bot, event))
+    {
+        e->validIn = validIn;
+        MarkEventDirty(bot, e->eventId);
+    }
+}
+
+void RandomPlayerbotMgr::MarkEventDirty(uint32 bot, uint32 eventId)
+{
+    if (!dirtyEvents[bot].insert(eventId).second)
+        return;
+
+    if (!pendingEventCount)
+        oldestDirtyEventTime = NowSeconds();
+
+    // map threads get here too, leave the write itself to the world update
+    if (++pendingEventCount >= sPlayerbotAIConfig.randomBotEventFlushMaxRows)
+        eventFlushRequested = true;
+}
+
+void RandomPlayerbotMgr::DropDirtyEvents(uint32 bot)
+{
+    auto found = dirtyEvents.find(bot);
+    if (found == dirtyEvents.end())
+        return;
+
+    pendingEventCount -= found->second.size();
+    dirtyEvents.erase(found);
+}
+
+void RandomPlayerbotMgr::FlushEventValues(bool wait)
+{
+    // No unique key on (owner, bot, event), so each chunk is one multi-row DELETE followed by one
+    // multi-row INSERT. Everything goes into a single transaction: after a crash the table holds
+    // either the previous flush or this one, never a half-written key.
+    static constexpr uint32 rowsPerStatement = 500;
+
+    std::unique_lock<std::recursive_mutex> guard(eventLock);
+    eventFlushRequested = false;
+    if (!pendingEventCount)
+        return;
+
+    // Changes made from here on are dirty again and go into the next flush
+    std::unordered_map<uint32, std::unordered_set<uint32>> events;
+    events.swap(dirtyEvents);
+    uint32 const rows = pendingEventCount;
+    pendingEventCount = 0;
+    oldestDirtyEventTime = 0;
+
+    PlayerbotsDatabaseTransaction trans = PlayerbotsDatabase.BeginTransaction();
+    std::ostringstream deletes;
+    std::ostringstream inserts;
+    uint32 deleteRows = 0;
+    uint32 insertRows = 0;
+
+    auto appendChunk = [&]()
+    {
+        if (deleteRows)
+            trans->Append(("DELETE FROM playerbots_random_bots WHERE owner = 0 AND (" + deletes.str() + ")").c_str());
+
+        if (insertRows)
+            trans->Append(("INSERT INTO playerbots_random_bots (owner, bot, time, validIn, event, value, data) "
+                           "VALUES " + inserts.str()).c_str());
+
+        deletes.str("");
+        inserts.str("");
+        deleteRows = 0;
+        insertRows = 0;
+    };
+
+    for (auto const& [bot, eventIdsOfBot] : events)
+    {
+        auto cache = eventCache.find(bot);
+
+        for (uint32 eventId : eventIdsOfBot)
+        {
+            std::string escapedEvent = eventNames[eventId];
+            PlayerbotsDatabase.EscapeString(escapedEvent);
+
+            deletes << (deleteRows++ ? " OR " : "") << "(bot = " << bot << " AND event = '" << escapedEvent << "')";
+
+            if (cache != eventCache.end())
+            {
+                if (CachedEvent const* cached = cache->second.Find(eventId))
+                {
+                    CachedEvent const& e = *cached;
+
+                    inserts << (insertRows++ ? ", " : "") << "(0, " << bot << ", " << e.lastChangeTime << ", "
+                            << e.validIn << ", '" << escapedEvent << "', " << e.value << ", ";
+
+                    if (e.data.empty())
+                    {
+                        inserts << "NULL)";
+                    }
+                    else
+                    {
+                        std::string escapedData = e.data;
+                        PlayerbotsDatabase.EscapeString(escapedData);
+                        inserts << "'" << escapedData << "')";
+                    }
+                }
+            }
+
+            if (deleteRows >= rowsPerStatement)
+                appendChunk();
+        }
+    }
+
+    appendChunk();
+    guard.unlock();
+
+    // Queued behind the earlier flushes, so a key written twice ends up with the later row
+    if (wait)
+        PlayerbotsDatabase.DirectCommitTransaction(trans);
+    else
+        PlayerbotsDatabase.CommitTransaction(trans);
+
+    if (sPlayerbotAIConfig.perfMonEnabled)
+        sPerfMonitor.RecordCount("RandomBot event rows written per flush", rows);
+}
+
 uint32 RandomPlayerbotMgr::GetValue(uint32 bot, std::string const& type) { return GetEventValue(bot, type); }
 
 uint32 RandomPlayerbotMgr::GetValue(Player* bot, std::string const& type)
@@ -2371,7 +2631,10 @@ bool RandomPlayerbotMgr::HandlePlayerbotConsoleCommand(ChatHandler* handler, cha
     if (cmd == "reset")
     {
         PlayerbotsDatabase.Execute(PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_DEL_RANDOM_BOTS));
+        std::lock_guard<std::recursive_mutex> guard(sRandomPlayerbotMgr.eventLock);
         sRandomPlayerbotMgr.eventCache.clear();
+        sRandomPlayerbotMgr.dirtyEvents.clear();
+        sRandomPlayerbotMgr.pendingEventCount = 0;
         LOG_INFO("playerbots", "Random bots were reset for all players. Please restart the Server.");
         return true;
     }
@@ -2516,7 +2779,120 @@ void RandomPlayerbotMgr::OnPlayerLogout(Player* player)
 
     std::vector<Player*>::iterator i = std::find(players.begin(), players.end(), player);
     if (i != players.end())
+    {
         players.erase(i);
+        RebuildPresenceIndex();
+    }
+}
+
+uint64 PlayerPresenceIndex::CellKey(uint32 mapId, int32 cellX, int32 cellY) const
+{
+    // 20 bits per cell coordinate cover the whole map even with a 1 yard radius
+    return (uint64(mapId) << 40) | (uint64((cellX + (1 << 19)) & 0xFFFFF) << 20) | uint64((cellY + (1 << 19)) & 0xFFFFF);
+}
+
+int32 PlayerPresenceIndex::CellCoord(float coord) const
+{
+    return static_cast<int32>(std::floor(coord / cellSize));
+}
+
+bool PlayerPresenceIndex::HasPlayerInRadius(uint32 mapId, Position const& pos) const
+{
+    if (cellSize <= 0.0f || cells.empty())
+        return false;
+
+    // the radius equals the cell size, so every point in range lies in the 3x3 cells around pos
+    float sqRange = cellSize * cellSize;
+    int32 cellX = CellCoord(pos.GetPositionX());
+    int32 cellY = CellCoord(pos.GetPositionY());
+    for (int32 x = cellX - 1; x <= cellX + 1; ++x)
+    {
+        for (int32 y = cellY - 1; y <= cellY + 1; ++y)
+        {
+            auto cell = cells.find(CellKey(mapId, x, y));
+            if (cell == cells.end())
+                continue;
+
+            for (Position const& point : cell->second)
+            {
+                if (pos.GetExactDistSq(point.GetPositionX(), point.GetPositionY(), point.GetPositionZ()) < sqRange)
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool PlayerPresenceIndex::IsFriendOfPlayer(ObjectGuid guid) const
+{
+    for (PlayerSocial* social : socials)
+    {
+        if (social->HasFriend(guid))
+            return true;
+    }
+
+    return false;
+}
+
+void RandomPlayerbotMgr::UpdatePresenceIndex(uint32 diff)
+{
+    // AllowActive caches its result for about 5 seconds, a second old position is precise enough
+    presenceIndexTimer += diff;
+    if (presenceIndexTimer < 1000)
+        return;
+
+    RebuildPresenceIndex();
+}
+
+void RandomPlayerbotMgr::RebuildPresenceIndex()
+{
+    presenceIndexTimer = 0;
+
+    presenceIndex.maps.clear();
+    presenceIndex.zones.clear();
+    presenceIndex.cells.clear();
+    presenceIndex.socials.clear();
+    presenceIndex.cellSize = static_cast<float>(sPlayerbotAIConfig.BotActiveAloneForceWhenInRadius);
+
+    for (Player* player : players)
+    {
+        if (!player || !player->GetSession() || !player->IsInWorld() || player->IsDuringRemoveFromWorld() ||
+            player->GetSession()->isLogingOut())
+            continue;
+
+        uint32 mapId = player->GetMapId();
+        bool isGM = player->IsGameMaster();
+
+        if (!(isGM && !player->IsVisible()))
+        {
+            presenceIndex.maps.insert(mapId);
+            presenceIndex.zones.insert(PlayerPresenceIndex::ZoneKey(mapId, player->GetZoneId()));
+        }
+
+        if (presenceIndex.cellSize > 0.0f && (!isGM || player->isGMVisible()))
+        {
+            presenceIndex.cells[presenceIndex.CellKey(mapId, presenceIndex.CellCoord(player->GetPositionX()),
+                                                      presenceIndex.CellCoord(player->GetPositionY()))]
+                .push_back(player->GetPosition());
+
+            WorldObject* viewObj = player->GetViewpoint();
+            if (viewObj && viewObj != player)
+            {
+                presenceIndex.cells[presenceIndex.CellKey(mapId, presenceIndex.CellCoord(viewObj->GetPositionX()),
+                                                          presenceIndex.CellCoord(viewObj->GetPositionY()))]
+                    .push_back(viewObj->GetPosition());
+            }
+        }
+
+        // as the friend check did before the index, players without an AI are skipped
+        PlayerbotAI* playerAI = GET_PLAYERBOT_AI(player);
+        if (!playerAI || !playerAI->IsRealPlayer())
+            continue;
+
+        if (PlayerSocial* social = player->GetSocial())
+            presenceIndex.socials.push_back(social);
+    }
 }
 
 void RandomPlayerbotMgr::OnBotLoginInternal(Player* const bot)
@@ -2630,13 +3006,14 @@ void RandomPlayerbotMgr::OnPlayerLogin(Player* player)
     {
         players.push_back(player);
         LOG_DEBUG("playerbots", "Including non-random bot player {} into random bot update", player->GetName().c_str());
+        RebuildPresenceIndex();
     }
 }
 
 void RandomPlayerbotMgr::OnPlayerLoginError(uint32 bot)
 {
     SetEventValue(bot, "add", 0, 0);
-    currentBots.remove(bot);
+    botRoster.Remove(bot);
 }
 
 Player* RandomPlayerbotMgr::GetRandomPlayer()
@@ -2652,6 +3029,7 @@ void RandomPlayerbotMgr::PrintStats()
 {
     printStatsTimer = time(nullptr);
     LOG_INFO("playerbots", "Random Bots Stats: {} online", playerBots.size());
+    LOG_INFO("playerbots", "Random bot event rows pending write: {}", GetPendingEventCount());
 
     std::map<uint8, uint32> alliance, horde;
     for (uint32 i = 0; i < 10; ++i)
@@ -3023,7 +3401,11 @@ void RandomPlayerbotMgr::Remove(Player* bot)
     PlayerbotsDatabase.Execute(stmt);
 
     uint32 botId = owner.GetCounter();
-    eventCache.erase(botId);
+    {
+        std::lock_guard<std::recursive_mutex> guard(eventLock);
+        eventCache.erase(botId);
+        DropDirtyEvents(botId);
+    }
 
     LogoutPlayerBot(owner);
 }
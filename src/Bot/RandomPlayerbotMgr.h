@@ -6,11 +6,16 @@
 #ifndef _PLAYERBOT_RANDOMPLAYERBOTMGR_H
 #define _PLAYERBOT_RANDOMPLAYERBOTMGR_H
 
+#include <array>
+#include <atomic>
+#include <mutex>
+
 #include "NewRpgInfo.h"
 #include "ObjectGuid.h"
 #include "PlayerbotMgr.h"
 #include "GameTime.h"
 #include "PlayerbotCommandServer.h"
+#include "RandomBotRoster.h"
 
 struct BattlegroundInfo
 {
@@ -45,10 +50,12 @@ struct BattlegroundInfo
 
 class ChatHandler;
 class PerfMonitorOperation;
+class PlayerSocial;
 class WorldLocation;
 
 struct CachedEvent
 {
+    uint32 eventId = 0;  // interned event name, see RandomPlayerbotMgr::InternEvent
     uint32 value = 0;
     uint32 lastChangeTime = 0;
     uint32 validIn = 0;
@@ -57,10 +64,73 @@ struct CachedEvent
     bool IsEmpty() const { return !lastChangeTime; }
 };
 
+// A bot has a few dozen events at most, so they are kept in one vector and scanned linearly
 struct BotEventCache
 {
     bool loaded = false;
-    std::unordered_map<std::string, CachedEvent> events;
+    std::vector<CachedEvent> events;
+
+    CachedEvent* Find(uint32 eventId)
+    {
+        for (CachedEvent& e : events)
+            if (e.eventId == eventId)
+                return &e;
+
+        return nullptr;
+    }
+
+    CachedEvent& FindOrAdd(uint32 eventId)
+    {
+        if (CachedEvent* e = Find(eventId))
+            return *e;
+
+        CachedEvent& e = events.emplace_back();
+        e.eventId = eventId;
+        return e;
+    }
+
+    void Erase(uint32 eventId)
+    {
+        if (CachedEvent* e = Find(eventId))
+        {
+            if (e != &events.back())
+                *e = std::move(events.back());
+
+            events.pop_back();
+        }
+    }
+};
+
+/**
+ * Where real players are, for the presence checks of PlayerbotAI::AllowActive.
+ *
+ * Rebuilt by the world thread (RandomPlayerbotMgr::UpdatePresenceIndex) and only read by map threads,
+ * which do not run concurrently with it. Positions are those of the last rebuild.
+ */
+struct PlayerPresenceIndex
+{
+    std::unordered_set<uint32> maps;                                // maps with a player not hidden as GM
+    std::unordered_set<uint64> zones;                               // (map id << 32) | zone id, same filter
+    std::unordered_map<uint64, std::vector<Position>> cells;        // GM-visible players and their viewpoints
+    std::vector<PlayerSocial*> socials;                             // friend lists of real players
+    float cellSize = 0.0f;                                          // BotActiveAloneForceWhenInRadius
+
+    bool HasPlayerInMap(uint32 mapId) const { return maps.count(mapId); }
+    bool HasPlayerInZone(uint32 mapId, uint32 zoneId) const { return zones.count(ZoneKey(mapId, zoneId)); }
+    bool HasPlayerInRadius(uint32 mapId, Position const& pos) const;
+    bool IsFriendOfPlayer(ObjectGuid guid) const;
+
+    static uint64 ZoneKey(uint32 mapId, uint32 zoneId) { return (uint64(mapId) << 32) | zoneId; }
+    uint64 CellKey(uint32 mapId, int32 cellX, int32 cellY) const;
+    int32 CellCoord(float coord) const;
+};
+
+// Priority classes of bots throttled by SmartScale, admitted in this order
+enum ActivityClass : uint8
+{
+    ACTIVITY_CLASS_NEAR_PLAYER,  // a real player is on the same map
+    ACTIVITY_CLASS_IDLE,
+    MAX_ACTIVITY_CLASSES
 };
 
 // https://gist.github.com/bradley219/5373998
@@ -118,7 +188,10 @@ public:
     void OnPlayerLogin(Player* player);
     void OnPlayerLoginError(uint32 bot);
     Player* GetRandomPlayer();
-    std::vector<Player*> GetPlayers() { return players; };
+    std::vector<Player*> const& GetPlayers() const { return players; };
+    PlayerPresenceIndex const& GetPresenceIndex() const { return presenceIndex; }
+    void UpdatePresenceIndex(uint32 diff);
+    void RebuildPresenceIndex();
     PlayerBotMap GetAllBots() { return playerBots; };
     void PrintStats();
     double GetBuyMultiplier(Player* bot);
@@ -141,6 +214,25 @@ public:
     void SetValue(uint32 bot, std::string const& type, uint32 value, std::string const& data = "");
     void SetValue(Player* bot, std::string const& type, uint32 value, std::string const& data = "");
     void Remove(Player* bot);
+
+    /**
+     * @brief Writes all dirty random bot events to playerbots_random_bots in one transaction
+     *
+     * The in-memory event cache is authoritative; SetEventValue only marks the (bot, event) key
+     * dirty and the world update flushes them. The statements are built under eventLock and
+     * committed after releasing it, asynchronously unless wait is set. Read events through the
+     * cache (GetEventBots) rather than the table; pass wait only where the rows must be in the
+     * table when this returns.
+     */
+    void FlushEventValues(bool wait = false);
+    // Random bots holding a live event, only those with the given value unless it is 0; ascending bot ids
+    std::vector<uint32> GetEventBots(std::string const& event, uint32 value = 0);
+    uint32 GetPendingEventCount() const
+    {
+        std::lock_guard<std::recursive_mutex> guard(eventLock);
+        return pendingEventCount;
+    }
+
     ObjectGuid GetBattleMasterGUID(Player* bot, BattlegroundTypeId bgTypeId);
     CreatureData const* GetCreatureDataByEntry(uint32 entry);
     void LoadBattleMastersCache();
@@ -158,9 +250,20 @@ public:
         return BattleMastersCache;
     }
 
-    float getActivityMod() { return activityMod; }
-    float getActivityPercentage() { return activityMod * 100.0f; }
-    void setActivityPercentage(float percentage) { activityMod = percentage / 100.0f; }
+    /**
+     * @brief Runs the SmartScale governor once per second (world thread)
+     *
+     * Drives the activity budget, the share of BotActiveAlone kept active, towards the configured tick
+     * time with the PID controller and splits it between the activity classes in priority order.
+     */
+    void UpdateActivityGovernor(uint32 diff);
+    float GetActivityBudget() const { return activityBudget.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Counts a throttled bot of the class and returns the admitted share of the class
+     * @return Per mille of the bots of this class that may be active
+     */
+    uint32 AdmitActivityClass(ActivityClass activityClass);
     static uint8 GetTeamClassIdx(bool isAlliance, uint8 claz) { return isAlliance * 20 + claz; }
 
     void PrepareAddclassCache();
@@ -212,17 +315,27 @@ private:
     RandomPlayerbotMgr(RandomPlayerbotMgr&&) = delete;
     RandomPlayerbotMgr& operator=(RandomPlayerbotMgr&&) = delete;
 
-    // pid values are set in constructor
-    botPID pid = botPID(1, 50, -50, 0, 0, 0);
-    float activityMod = 0.25;
+    // output is the change of the activity budget per second, gains are set from the config on every step
+    botPID pid = botPID(1, 0.1, -0.25, 0, 0, 0);
+    std::atomic<float> activityBudget{1.0f};
+    std::array<std::atomic<uint32>, MAX_ACTIVITY_CLASSES> activityClassReports{};
+    std::array<std::atomic<uint32>, MAX_ACTIVITY_CLASSES> activityClassShares{};
+    std::array<float, MAX_ACTIVITY_CLASSES> activityClassLoad{};
+    uint32 activityGovernorTimer = 0;
     bool _isBotInitializing = true;
     bool _isBotLogging = true;
     NewRpgStatistic rpgStasticTotal;
-    CachedEvent* FindEvent(uint32 bot, std::string const& event);
+    CachedEvent* FindEvent(uint32 bot, std::string const& event);  // caller holds eventLock while using the result
     uint32 GetEventValue(uint32 bot, std::string const& event);
     std::string GetEventData(uint32 bot, std::string const& event);
     uint32 SetEventValue(uint32 bot, std::string const& event, uint32 value, uint32 validIn,
                          std::string const& data = "");
+    void SetEventValidIn(uint32 bot, std::string const& event, uint32 validIn);
+    void MarkEventDirty(uint32 bot, uint32 eventId);
+    uint32 InternEvent(std::string const& event);
+    void LoadEventCache();
+    void DropDirtyEvents(uint32 bot);
+    uint32 GetBotDueTime(uint32 bot);  // earliest expiry of the bot's "update" and "add" events
     void GetBots();
     std::vector<uint32> GetBgBots(uint32 bracket);
     time_t BgCheckTimer;
@@ -239,13 +352,25 @@ private:
     uint32 GetZoneLevel(uint16 mapId, float teleX, float teleY, float teleZ);
     typedef void (RandomPlayerbotMgr::*ConsoleCommandHandler)(Player*);
     std::vector<Player*> players;
+    PlayerPresenceIndex presenceIndex;
+    uint32 presenceIndexTimer = 0;
     uint32 processTicks;
 
     // std::map<uint32, std::vector<WorldLocation>> rpgLocsCache;
     std::map<uint32, std::map<uint32, std::vector<WorldLocation>>> rpgLocsCacheLevel;
     std::map<TeamId, std::map<BattlegroundTypeId, std::vector<uint32>>> BattleMastersCache;
+    // Map threads set events of the bots they update while the world thread reads and flushes them,
+    // guards the event cache, the dirty set and the interned event names below
+    mutable std::recursive_mutex eventLock;
     std::unordered_map<uint32, BotEventCache> eventCache;
-    std::list<uint32> currentBots;
+    std::unordered_map<uint32, std::unordered_set<uint32>> dirtyEvents;  // bot -> event ids not yet written
+    std::unordered_map<std::string, uint32> eventIds;
+    std::vector<std::string> eventNames;  // event id -> name
+    bool eventCachePreloaded = false;      // every bot with stored events is in eventCache
+    uint32 pendingEventCount = 0;
+    uint32 oldestDirtyEventTime = 0;
+    bool eventFlushRequested = false;  // MaxRows reached, the next world update flushes
+    RandomBotRoster botRoster;
     uint32 bgBotsCount;
     uint32 playersLevel;
 
@@ -253,7 +378,6 @@ private:
     std::vector<uint32> rndBotTypeAccounts;             // Accounts marked as RNDbot (type 1)
     std::vector<uint32> addClassTypeAccounts;           // Accounts marked as AddClass (type 2)
 
-    //void ScaleBotActivity();      // Deprecated function
     static inline uint32 NowSeconds() { return static_cast<uint32>(GameTime::GetGameTime().count()); }
 };
 
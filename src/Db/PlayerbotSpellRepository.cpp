@@ -1,7 +1,12 @@
+#include <cctype>
+
 #include "Log.h"
 #include "DBCStores.h"
 #include "DatabaseEnv.h"
 #include "Field.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include "Util.h"
 // Required due to poor implementation on AC side
 #include "QueryResult.h"
 
@@ -37,6 +42,10 @@ void PlayerbotSpellRepository::Initialize()
         LOG_DEBUG("playerbots",
             "ListSpellsAction: initialized caches (skillSpells={}, vendorItems={}).",
             skillSpells.size(), vendorItems.size());
+
+    // The spell store is loaded before the world script initializes the module, triggers resolve their names
+    // when bots are created
+    BuildAuraNames();
 }
 
 SkillLineAbilityEntry const* PlayerbotSpellRepository::GetSkillLine(uint32 spellId) const
@@ -51,3 +60,64 @@ bool PlayerbotSpellRepository::IsItemBuyable(uint32 itemId) const
 {
     return vendorItems.find(itemId) != vendorItems.end();
 }
+
+AuraNameId PlayerbotSpellRepository::GetAuraNameId(std::string const& name) const
+{
+    auto itr = auraNames.find(NormalizeSpellName(name));
+    if (itr != auraNames.end())
+        return itr->second;
+    return AuraNameId();
+}
+
+std::string PlayerbotSpellRepository::NormalizeSpellName(std::string const& name)
+{
+    bool ascii = true;
+    for (char c : name)
+        ascii &= !(c & 0x80);
+
+    if (ascii)
+    {
+        std::string result = name;
+        for (char& c : result)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return result;
+    }
+
+    std::wstring wname;
+    if (!Utf8toWStr(name, wname))
+        return name;
+
+    wstrToLower(wname);
+
+    std::string result;
+    WStrToUtf8(wname, result);
+    return result;
+}
+
+void PlayerbotSpellRepository::BuildAuraNames()
+{
+    auraNames.clear();
+    spellsByName.clear();
+
+    uint32 storeSize = sSpellMgr->GetSpellInfoStoreSize();
+    spellAuraNames.assign(storeSize, AuraNameId());
+
+    for (uint32 spellId = 1; spellId < storeSize; ++spellId)
+    {
+        SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(spellId);
+        if (!spellInfo || !spellInfo->SpellName[0] || !*spellInfo->SpellName[0])
+            continue;
+
+        auto itr = auraNames.try_emplace(NormalizeSpellName(spellInfo->SpellName[0]),
+                                         AuraNameId{static_cast<uint32>(auraNames.size() + 1)}).first;
+        spellAuraNames[spellId] = itr->second;
+
+        if (spellsByName.size() < itr->second.id)
+            spellsByName.resize(itr->second.id);
+
+        spellsByName[itr->second.id - 1].push_back(spellId);
+    }
+
+    LOG_DEBUG("playerbots", "PlayerbotSpellRepository: indexed {} aura names over {} spells.", auraNames.size(),
+              storeSize);
+}
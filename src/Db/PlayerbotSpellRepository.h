@@ -7,9 +7,27 @@
 #define _PLAYERBOT_PLAYERBOTSPELLREPOSITORY_H
 
 #include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "DBCStructure.h"
 
+/**
+ * Interned, case-insensitive spell name. Resolve it once (e.g. in a trigger constructor) and pass it to
+ * PlayerbotAI::HasAura / GetAura instead of the name. The default handle matches no spell.
+ */
+struct AuraNameId
+{
+    uint32_t id = 0;
+
+    explicit operator bool() const { return id != 0; }
+    bool operator==(AuraNameId const& other) const { return id == other.id; }
+    bool operator!=(AuraNameId const& other) const { return id != other.id; }
+};
+
 class PlayerbotSpellRepository
 {
 public:
@@ -25,6 +43,29 @@ public:
     SkillLineAbilityEntry const* GetSkillLine(uint32_t spellId) const;
     bool IsItemBuyable(uint32_t itemId) const;
 
+    /**
+     * @brief Interned id of a spell name, compared case-insensitively as HasAura always did
+     * @return An empty handle if no spell has this name
+     */
+    AuraNameId GetAuraNameId(std::string const& name) const;
+
+    /**
+     * @brief Interned name id of a spell, for comparing applied auras against an AuraNameId
+     */
+    AuraNameId GetSpellAuraNameId(uint32_t spellId) const
+    {
+        return spellId < spellAuraNames.size() ? spellAuraNames[spellId] : AuraNameId();
+    }
+
+    /**
+     * @brief All spells carrying the name, in ascending spell id order
+     */
+    std::vector<uint32_t> const& GetSpellsWithName(AuraNameId nameId) const
+    {
+        static std::vector<uint32_t> const none;
+        return nameId && nameId.id <= spellsByName.size() ? spellsByName[nameId.id - 1] : none;
+    }
+
 private:
     PlayerbotSpellRepository() = default;
     ~PlayerbotSpellRepository() = default;
@@ -35,8 +76,16 @@ private:
     PlayerbotSpellRepository(PlayerbotSpellRepository&&) = delete;
     PlayerbotSpellRepository& operator=(PlayerbotSpellRepository&&) = delete;
 
+    // Built by Initialize from the loaded spell store, read-only afterwards
+    void BuildAuraNames();
+    static std::string NormalizeSpellName(std::string const& name);
+
     std::map<uint32_t, SkillLineAbilityEntry const*> skillSpells;
     std::set<uint32_t> vendorItems;
+
+    std::unordered_map<std::string, AuraNameId> auraNames;
+    std::vector<AuraNameId> spellAuraNames;         // indexed by spell id
+    std::vector<std::vector<uint32_t>> spellsByName;  // indexed by name id - 1
 };
 
 #endif
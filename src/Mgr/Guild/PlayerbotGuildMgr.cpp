@@ -1,6 +1,7 @@
 #include "PlayerbotGuildMgr.h"
 #include "Player.h"
 #include "PlayerbotAIConfig.h"
+#include "RandomPlayerbotMgr.h"
 #include "DatabaseEnv.h"
 #include "Guild.h"
 #include "GuildMgr.h"
@@ -245,19 +246,7 @@ void PlayerbotGuildMgr::ValidateGuildCache()
 void PlayerbotGuildMgr::DeleteBotGuilds()
 {
     LOG_INFO("playerbots", "Deleting random bot guilds...");
-    std::vector<uint32> randomBots;
-
-    PlayerbotsDatabasePreparedStatement* stmt = PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_SEL_RANDOM_BOTS_BOT);
-    stmt->SetData(0, "add");
-    if (PreparedQueryResult result = PlayerbotsDatabase.Query(stmt))
-    {
-        do
-        {
-            Field* fields = result->Fetch();
-            uint32 bot = fields[0].Get<uint32>();
-            randomBots.push_back(bot);
-        } while (result->NextRow());
-    }
+    std::vector<uint32> randomBots = sRandomPlayerbotMgr.GetEventBots("add");
 
     for (std::vector<uint32>::iterator i = randomBots.begin(); i != randomBots.end(); ++i)
     {
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#include "FlatItemTable.h"
+
+#include <algorithm>
+#include <utility>
+
+void FlatItemTable::Assign(Rows const& rows)
+{
+    Clear();
+
+    if (rows.empty())
+        return;
+
+    uint32 maxSubKey = 0;
+    size_t count = 0;
+    for (auto const& [key, lists] : rows)
+    {
+        for (auto const& [subKey, list] : lists)
+        {
+            maxSubKey = std::max(maxSubKey, subKey);
+            count += list.size();
+        }
+    }
+
+    keys = rows.rbegin()->first + 1;
+    subKeys = maxSubKey + 1;
+    offsets.assign(size_t(keys) * subKeys + 1, 0);
+    items.reserve(count);
+
+    // rows are visited in (key, subKey) order, the same order as the offsets
+    uint32 row = 0;
+    for (auto const& [key, lists] : rows)
+    {
+        for (auto const& [subKey, list] : lists)
+        {
+            uint32 const target = key * subKeys + subKey;
+            for (; row < target; ++row)
+                offsets[row + 1] = items.size();
+
+            items.insert(items.end(), list.begin(), list.end());
+            offsets[++row] = items.size();
+        }
+    }
+
+    for (; row < offsets.size() - 1; ++row)
+        offsets[row + 1] = items.size();
+}
+
+bool FlatItemTable::Assign(uint32 keyCount, uint32 subKeyCount, std::vector<uint32> rowOffsets,
+                           std::vector<uint32> rowItems)
+{
+    Clear();
+
+    if (!keyCount || !subKeyCount)
+        return rowOffsets.size() <= 1 && rowItems.empty();
+
+    if (uint64(keyCount) * subKeyCount + 1 != rowOffsets.size() || rowOffsets.front() != 0 ||
+        rowOffsets.back() != rowItems.size())
+        return false;
+
+    for (size_t i = 1; i < rowOffsets.size(); ++i)
+    {
+        if (rowOffsets[i] < rowOffsets[i - 1])
+            return false;
+    }
+
+    keys = keyCount;
+    subKeys = subKeyCount;
+    offsets = std::move(rowOffsets);
+    items = std::move(rowItems);
+    return true;
+}
+
+void FlatItemTable::Clear()
+{
+    keys = 0;
+    subKeys = 0;
+    offsets.clear();
+    items.clear();
+}
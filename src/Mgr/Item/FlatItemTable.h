@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#ifndef _PLAYERBOT_FLATITEMTABLE_H
+#define _PLAYERBOT_FLATITEMTABLE_H
+
+#include <map>
+#include <span>
+#include <vector>
+
+#include "Define.h"
+
+/**
+ * @brief Read-only item id lists keyed by (key, subKey), e.g. (level, inventory type)
+ *
+ * The lists are stored back to back in one array, and a dense offset array with one entry per
+ * (key, subKey) pair points at the start of each list (compressed sparse rows). A lookup is two
+ * loads and never allocates, missing pairs yield an empty span.
+ *
+ * Keys are expected to be small (levels, inventory types, categories), the offset array has
+ * (maxKey + 1) * (maxSubKey + 1) + 1 entries.
+ */
+class FlatItemTable
+{
+public:
+    typedef std::map<uint32, std::map<uint32, std::vector<uint32>>> Rows;
+
+    /**
+     * @brief Replaces the content with the given lists, keeping the order of the items of each list
+     */
+    void Assign(Rows const& rows);
+
+    /**
+     * @brief Replaces the content with raw arrays as returned by the accessors below
+     * @return false, leaving the table empty, if the arrays are not consistent
+     */
+    bool Assign(uint32 keyCount, uint32 subKeyCount, std::vector<uint32> rowOffsets, std::vector<uint32> rowItems);
+
+    void Clear();
+
+    std::span<uint32 const> Get(uint32 key, uint32 subKey = 0) const
+    {
+        if (key >= keys || subKey >= subKeys)
+            return {};
+
+        uint32 const row = key * subKeys + subKey;
+        return {items.data() + offsets[row], offsets[row + 1] - offsets[row]};
+    }
+
+    uint32 KeyCount() const { return keys; }
+    uint32 SubKeyCount() const { return subKeys; }
+    std::vector<uint32> const& Offsets() const { return offsets; }
+    std::vector<uint32> const& Items() const { return items; }
+
+private:
+    uint32 keys = 0;
+    uint32 subKeys = 0;
+    std::vector<uint32> offsets;
+    std::vector<uint32> items;
+};
+
+#endif
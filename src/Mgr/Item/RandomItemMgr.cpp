@@ -5,6 +5,13 @@
 
 #include "RandomItemMgr.h"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <type_traits>
+
 #include "ItemTemplate.h"
 #include "LootValues.h"
 #include "Playerbots.h"
@@ -12,6 +19,119 @@
 char* strstri(char const* str1, char const* str2);
 std::set<uint32> RandomItemMgr::itemCache;
 
+namespace
+{
+    // Startup snapshot of the caches derived from the item and quest templates, see RandomItemMgr::Init
+    constexpr uint32 SNAPSHOT_MAGIC = 0x43494250;  // "PBIC"
+    constexpr uint32 SNAPSHOT_VERSION = 2;
+    constexpr uint64 FNV_OFFSET = 0xCBF29CE484222325ULL;
+    constexpr uint64 FNV_PRIME = 0x100000001B3ULL;
+
+    void HashBytes(uint64& hash, void const* data, size_t size)
+    {
+        unsigned char const* bytes = static_cast<unsigned char const*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+    }
+
+    template <class T>
+    void HashValue(uint64& hash, T value)
+    {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+        HashBytes(hash, &value, sizeof(value));
+    }
+
+    void HashValue(uint64& hash, std::string const& value)
+    {
+        HashValue(hash, value.size());
+        HashBytes(hash, value.data(), value.size());
+    }
+
+    class SnapshotWriter
+    {
+    public:
+        template <class T>
+        void Put(T value)
+        {
+            char const* bytes = reinterpret_cast<char const*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+        }
+
+        void PutList(std::vector<uint32> const& list)
+        {
+            Put(uint32(list.size()));
+            char const* bytes = reinterpret_cast<char const*>(list.data());
+            buffer.insert(buffer.end(), bytes, bytes + list.size() * sizeof(uint32));
+        }
+
+        // key and subKey counts, then the offset and item arrays as stored
+        void PutTable(FlatItemTable const& table)
+        {
+            Put(table.KeyCount());
+            Put(table.SubKeyCount());
+            PutList(table.Offsets());
+            PutList(table.Items());
+        }
+
+        std::vector<char> const& Data() const { return buffer; }
+
+    private:
+        std::vector<char> buffer;
+    };
+
+    class SnapshotReader
+    {
+    public:
+        SnapshotReader(std::vector<char> const& data) : pos(data.data()), end(data.data() + data.size()) {}
+
+        template <class T>
+        bool Get(T& value)
+        {
+            if (size_t(end - pos) < sizeof(value))
+                return false;
+
+            memcpy(&value, pos, sizeof(value));
+            pos += sizeof(value);
+            return true;
+        }
+
+        bool GetList(std::vector<uint32>& list)
+        {
+            uint32 count = 0;
+            if (!Get(count) || size_t(end - pos) / sizeof(uint32) < count)
+                return false;
+
+            list.resize(count);
+            if (count)
+                memcpy(list.data(), pos, count * sizeof(uint32));
+
+            pos += count * sizeof(uint32);
+            return true;
+        }
+
+        bool GetTable(FlatItemTable& table)
+        {
+            uint32 keys = 0;
+            uint32 subKeys = 0;
+            std::vector<uint32> offsets;
+            std::vector<uint32> items;
+            if (!Get(keys) || !Get(subKeys) || !GetList(offsets) || !GetList(items))
+                return false;
+
+            return table.Assign(keys, subKeys, std::move(offsets), std::move(items));
+        }
+
+        bool AtEnd() const { return pos == end; }
+
+    private:
+        char const* pos;
+        char const* end;
+    };
+}
+
 uint64 BotEquipKey::GetKey() { return level + 100 * clazz + 10000 * slot + 1000000 * quality; }
 
 class RandomItemGuildTaskPredicate : public RandomItemPredicate
@@ -153,13 +273,200 @@ RandomItemMgr::RandomItemMgr()
 
 void RandomItemMgr::Init()
 {
+    uint32 oldMSTime = getMSTime();
+
     BuildItemInfoCache();
+
+    // Everything below only depends on the item and quest templates and a few options, so it is
+    // reused from the snapshot of the previous start as long as those did not change
+    std::string snapshot;
+    uint64 snapshotKey = 0;
+    if (!sPlayerbotAIConfig.itemCacheSnapshotFile.empty())
+    {
+        snapshot = sWorld->GetDataPath() + sPlayerbotAIConfig.itemCacheSnapshotFile;
+        snapshotKey = GetSnapshotKey();
+
+        if (LoadSnapshot(snapshot, snapshotKey))
+        {
+            LOG_INFO("server.loading", ">> Loaded random item caches from {} in {} ms", snapshot,
+                     GetMSTimeDiffToNow(oldMSTime));
+            return;
+        }
+    }
+
+    BuildTestItemCache();
     // BuildEquipCache();
-    BuildEquipCacheNew();
-    BuildAmmoCache();
-    BuildPotionCache();
-    BuildFoodCache();
-    BuildTradeCache();
+
+    // The caches are independent of each other
+    std::vector<std::future<void>> builds;
+    builds.push_back(std::async(std::launch::async, &RandomItemMgr::BuildEquipCacheNew, this));
+    builds.push_back(std::async(std::launch::async, &RandomItemMgr::BuildAmmoCache, this));
+    builds.push_back(std::async(std::launch::async, &RandomItemMgr::BuildPotionCache, this));
+    builds.push_back(std::async(std::launch::async, &RandomItemMgr::BuildFoodCache, this));
+    builds.push_back(std::async(std::launch::async, &RandomItemMgr::BuildTradeCache, this));
+
+    for (std::future<void>& build : builds)
+        build.get();
+
+    if (!snapshot.empty())
+        SaveSnapshot(snapshot, snapshotKey);
+
+    LOG_INFO("server.loading", ">> Built random item caches in {} ms", GetMSTimeDiffToNow(oldMSTime));
+}
+
+uint64 RandomItemMgr::GetSnapshotKey() const
+{
+    uint64 key = FNV_OFFSET;
+    HashValue(key, SNAPSHOT_VERSION);
+    HashValue(key, sPlayerbotAIConfig.randomBotMaxLevel);
+    HashValue(key, sWorld->getIntConfig(CONFIG_MAX_PLAYER_LEVEL));
+    for (uint32 itemId : sPlayerbotAIConfig.unobtainableItems)
+        HashValue(key, itemId);
+
+    // The template stores are hash maps, entries are hashed on their own and summed so the key does
+    // not depend on iteration order. Only fields read by the cache builders are included.
+    uint64 items = 0;
+    for (auto const& itr : *sObjectMgr->GetItemTemplateStore())
+    {
+        ItemTemplate const& proto = itr.second;
+
+        uint64 hash = FNV_OFFSET;
+        HashValue(hash, proto.ItemId);
+        HashValue(hash, proto.Class);
+        HashValue(hash, proto.SubClass);
+        HashValue(hash, proto.Name1);
+        HashValue(hash, proto.Quality);
+        HashValue(hash, proto.Flags);
+        HashValue(hash, proto.InventoryType);
+        HashValue(hash, proto.AllowableClass);
+        HashValue(hash, proto.ItemLevel);
+        HashValue(hash, proto.RequiredLevel);
+        HashValue(hash, proto.RequiredSkill);
+        HashValue(hash, proto.RequiredHonorRank);
+        HashValue(hash, proto.RequiredCityRank);
+        HashValue(hash, proto.Stackable);
+        HashValue(hash, proto.Damage[0].DamageMin);
+        HashValue(hash, proto.Spells[0].SpellId);
+        HashValue(hash, proto.Spells[0].SpellCategory);
+        HashValue(hash, proto.Bonding);
+        HashValue(hash, proto.Area);
+        HashValue(hash, proto.Map);
+        HashValue(hash, proto.Duration);
+
+        if (SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(proto.Spells[0].SpellId))
+        {
+            for (uint8 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+                HashValue(hash, spellInfo->Effects[i].Effect);
+        }
+
+        items += hash;
+    }
+
+    uint64 quests = 0;
+    for (auto const& itr : sObjectMgr->GetQuestTemplates())
+    {
+        Quest const* quest = itr.second;
+
+        uint64 hash = FNV_OFFSET;
+        HashValue(hash, itr.first);
+        HashValue(hash, quest->IsRepeatable());
+        HashValue(hash, quest->GetQuestLevel());
+        HashValue(hash, quest->GetRequiredClasses());
+        for (uint32 i = 0; i < QUEST_REWARD_CHOICES_COUNT; ++i)
+            HashValue(hash, quest->RewardChoiceItemId[i]);
+        for (uint32 i = 0; i < QUEST_REWARDS_COUNT; ++i)
+            HashValue(hash, quest->RewardItemId[i]);
+
+        quests += hash;
+    }
+
+    HashValue(key, items);
+    HashValue(key, quests);
+    return key;
+}
+
+bool RandomItemMgr::LoadSnapshot(std::string const& path, uint64 key)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    std::streamoff size = file.tellg();
+    if (size <= 0)
+        return false;
+
+    std::vector<char> data(size);
+    file.seekg(0);
+    if (!file.read(data.data(), data.size()))
+        return false;
+
+    SnapshotReader reader(data);
+
+    uint32 magic = 0;
+    uint32 version = 0;
+    uint64 fileKey = 0;
+    if (!reader.Get(magic) || !reader.Get(version) || !reader.Get(fileKey) || magic != SNAPSHOT_MAGIC ||
+        version != SNAPSHOT_VERSION || fileKey != key)
+    {
+        LOG_INFO("server.loading", "Random item cache snapshot {} is outdated, rebuilding", path);
+        return false;
+    }
+
+    std::vector<uint32> testItems;
+    if (!reader.GetList(testItems) || !reader.GetTable(equipCacheNew) || !reader.GetTable(ammoCache) ||
+        !reader.GetTable(potionCache) || !reader.GetTable(foodCache) || !reader.GetTable(tradeCache) ||
+        !reader.AtEnd())
+    {
+        LOG_ERROR("playerbots", "Random item cache snapshot {} is damaged, rebuilding", path);
+        equipCacheNew.Clear();
+        ammoCache.Clear();
+        potionCache.Clear();
+        foodCache.Clear();
+        tradeCache.Clear();
+        return false;
+    }
+
+    itemForTest.insert(testItems.begin(), testItems.end());
+    return true;
+}
+
+void RandomItemMgr::SaveSnapshot(std::string const& path, uint64 key) const
+{
+    SnapshotWriter writer;
+    writer.Put(SNAPSHOT_MAGIC);
+    writer.Put(SNAPSHOT_VERSION);
+    writer.Put(key);
+
+    std::vector<uint32> testItems(itemForTest.begin(), itemForTest.end());
+    std::sort(testItems.begin(), testItems.end());
+    writer.PutList(testItems);
+
+    writer.PutTable(equipCacheNew);
+    writer.PutTable(ammoCache);
+    writer.PutTable(potionCache);
+    writer.PutTable(foodCache);
+    writer.PutTable(tradeCache);
+
+    // Written aside and renamed, an interrupted write never leaves a truncated snapshot
+    std::string const temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(writer.Data().data(), writer.Data().size()))
+        {
+            LOG_ERROR("playerbots", "Can't write random item cache snapshot {}", temp);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error)
+    {
+        LOG_ERROR("playerbots", "Can't replace random item cache snapshot {}: {}", path, error.message());
+        return;
+    }
+
+    LOG_INFO("server.loading", "Random item cache snapshot saved to {} ({} KB)", path, writer.Data().size() / 1024);
 }
 
 void RandomItemMgr::InitAfterAhBot()
@@ -447,9 +754,10 @@ bool RandomItemMgr::CheckItemStats(uint8 clazz, uint8 sp, uint8 ap, uint8 tank)
     return sp || ap || tank;
 }
 
-std::vector<uint32> RandomItemMgr::GetCachedEquipments(uint32 requiredLevel, uint32 inventoryType)
+std::span<uint32 const> RandomItemMgr::GetCachedEquipments(uint32 requiredLevel, uint32 inventoryType) const
 {
-    return equipCacheNew[requiredLevel][inventoryType];
+    // read only, equipment planning calls this from worker threads
+    return equipCacheNew.Get(requiredLevel, inventoryType);
 }
 
 bool RandomItemMgr::ShouldEquipArmorForSpec(uint8 playerclass, uint8 spec, ItemTemplate const* proto)
@@ -901,73 +1209,17 @@ void RandomItemMgr::BuildItemInfoCache()
     }
 
     if (m_weightScales[1].empty())
-    {
         LOG_ERROR("playerbots", "Error loading item weight scales");
-        return;
-    }
-
-    // vendor items
-    LOG_INFO("playerbots", "Loading vendor item list...");
-
-    std::set<uint32> vendorItems;
-    vendorItems.clear();
-    if (QueryResult result = WorldDatabase.Query("SELECT item FROM npc_vendor"))
-    {
-        do
-        {
-            Field* fields = result->Fetch();
-            int32 entry = fields[0].Get<int32>();
-            if (entry <= 0)
-                continue;
-
-            vendorItems.insert(entry);
-        } while (result->NextRow());
-    }
-
-    LOG_INFO("playerbots", "Loaded {} vendor items...", vendorItems.size());
-
-    // calculate drop source
-    LOG_INFO("playerbots", "Loading loot templates...");
-    DropMap* dropMap = new DropMap;
-
-    if (CreatureTemplateContainer const* creatures = sObjectMgr->GetCreatureTemplates())
-    {
-        for (CreatureTemplateContainer::const_iterator itr = creatures->begin(); itr != creatures->end(); ++itr)
-        {
-            uint32 sEntry = itr->first;
-            if (LootTemplateAccess const* lTemplateA =
-                    DropMapValue::GetLootTemplate(ObjectGuid::Create<HighGuid::Unit>(sEntry, uint32(1)), LOOT_CORPSE))
-                for (auto const& lItem : lTemplateA->Entries)
-                    dropMap->insert(std::make_pair(lItem->itemid, sEntry));
-        }
-    }
-
-    if (GameObjectTemplateContainer const* gameobjects = sObjectMgr->GetGameObjectTemplates())
-    {
-        for (auto const& itr : *gameobjects)
-        {
-            uint32 sEntry = itr.first;
-            if (LootTemplateAccess const* lTemplateA = DropMapValue::GetLootTemplate(
-                    ObjectGuid::Create<HighGuid::GameObject>(sEntry, uint32(1)), LOOT_CORPSE))
-                for (auto const& lItem : lTemplateA->Entries)
-                    dropMap->insert(std::make_pair(lItem->itemid, sEntry));
-        }
-    }
-
-    LOG_INFO("playerbots", "Loaded {} loot templates...", dropMap->size());
-
-    ItemTemplateContainer const* itemTemplate = sObjectMgr->GetItemTemplateStore();
-    LOG_INFO("playerbots", "Calculating stat weights for {} items...", itemTemplate->size());
-
-    PlayerbotsDatabaseTransaction trans = PlayerbotsDatabase.BeginTransaction();
+}
 
-    for (auto const& itr : *itemTemplate)
+void RandomItemMgr::BuildTestItemCache()
+{
+    ItemTemplateContainer const* itemTemplates = sObjectMgr->GetItemTemplateStore();
+    for (auto const& itr : *itemTemplates)
     {
         ItemTemplate const* proto = &itr.second;
-        if (!proto)
-            continue;
 
-        // skip test items
+        // skip test and deprecated items
         if (strstr(proto->Name1.c_str(), "(Test)") || strstr(proto->Name1.c_str(), "(TEST)") ||
             strstr(proto->Name1.c_str(), "(test)") || strstr(proto->Name1.c_str(), "(JEFFTEST)") ||
             strstr(proto->Name1.c_str(), "Test ") || strstr(proto->Name1.c_str(), "Test") ||
@@ -976,295 +1228,11 @@ void RandomItemMgr::BuildItemInfoCache()
             strstr(proto->Name1.c_str(), "Deprecated ") || strstr(proto->Name1.c_str(), "Unused ") ||
             strstr(proto->Name1.c_str(), "Monster ") || strstr(proto->Name1.c_str(), "[PH]") ||
             strstr(proto->Name1.c_str(), "(OLD)") || strstr(proto->Name1.c_str(), "QR") ||
-            strstr(proto->Name1.c_str(), "zzOLD"))
-        {
-            itemForTest.insert(proto->ItemId);
-            continue;
-        }
-
-        if (proto->HasFlag(ITEM_FLAG_DEPRECATED))
-        {
+            strstr(proto->Name1.c_str(), "zzOLD") || proto->HasFlag(ITEM_FLAG_DEPRECATED))
             itemForTest.insert(proto->ItemId);
-            continue;
-        }
-        // skip items with rank/rep requirements
-        /*if (proto->RequiredHonorRank > 0 ||
-            proto->RequiredSkillRank > 0 ||
-            proto->RequiredCityRank > 0 ||
-            proto->RequiredReputationRank > 0)
-            continue;*/
-
-        // if (proto->RequiredHonorRank > 0 || proto->RequiredSkillRank > 0 || proto->RequiredCityRank > 0)
-        //     continue;
-
-        // // skip random enchant items
-        // if (proto->RandomProperty)
-        //     continue;
-
-        // // skip heirloom items
-        // if (proto->Quality == ITEM_QUALITY_HEIRLOOM)
-        //     continue;
-
-        // // check possible equip slots
-        // EquipmentSlots slot = EQUIPMENT_SLOT_START;
-        // for (std::map<EquipmentSlots, std::set<InventoryType> >::iterator i = viableSlots.begin();
-        //      i != viableSlots.end(); ++i)
-        // {
-        //     std::set<InventoryType> slots = viableSlots[(EquipmentSlots)i->first];
-        //     if (slots.find((InventoryType)proto->InventoryType) != slots.end())
-        //         slot = i->first;
-        // }
-
-        // if (slot == EQUIPMENT_SLOT_START)
-        //     continue;
-
-        // Init Item cache
-        // ItemInfoEntry cacheInfo;
-
-        // for (uint8 clazz = CLASS_WARRIOR; clazz < MAX_CLASSES; ++clazz)
-        // {
-        //     // skip nonexistent classes
-        //     if (!((1 << (clazz - 1)) & CLASSMASK_ALL_PLAYABLE) || !sChrClassesStore.LookupEntry(clazz))
-        //         continue;
-
-        //     // skip wrong classes
-        //     if ((proto->AllowableClass & (1 << (clazz - 1))) == 0)
-        //         continue;
-
-        //     for (uint32 spec = 1; spec < 5; ++spec)
-        //     {
-        //         if (!m_weightScales[clazz][spec].info.id)
-        //             continue;
-
-        //         // check possible armor for spec
-        //         if (m_weightScales)
-        //         if (proto->Class == ITEM_CLASS_ARMOR && (
-        //             slot == EQUIPMENT_SLOT_HEAD ||
-        //             slot == EQUIPMENT_SLOT_SHOULDERS ||
-        //             slot == EQUIPMENT_SLOT_CHEST ||
-        //             slot == EQUIPMENT_SLOT_WAIST ||
-        //             slot == EQUIPMENT_SLOT_LEGS ||
-        //             slot == EQUIPMENT_SLOT_FEET ||
-        //             slot == EQUIPMENT_SLOT_WRISTS ||
-        //             slot == EQUIPMENT_SLOT_HANDS) &&
-        //             !ShouldEquipArmorForSpec(clazz, spec, proto))
-        //             continue;
-
-        //         // check possible weapon for spec
-        //         if ((proto->Class == ITEM_CLASS_WEAPON || (proto->SubClass == ITEM_SUBCLASS_ARMOR_SHIELD ||
-        //         (proto->SubClass == ITEM_SUBCLASS_ARMOR_MISC && proto->InventoryType == INVTYPE_HOLDABLE))) &&
-        //             !ShouldEquipWeaponForSpec(clazz, spec, proto))
-        //             continue;
-
-        //         StatWeight statWeight;
-        //         statWeight.id = m_weightScales[clazz][spec].info.id;
-        //         uint32 statW = CalculateStatWeight(clazz, spec, proto);
-        //         // set stat weight = 1 for items that can be equipped but have no proper stats
-        //         statWeight.weight = statW ? statW : 1;
-        //         //statWeight.weight = statW;
-        //         // save item statWeight into ItemCache
-        //         cacheInfo.weights[statWeight.id] = statWeight.weight;
-        //         LOG_DEBUG("playerbots", "Item: {}, weight: {}, class: {}, spec: {}", proto->ItemId,
-        //         statWeight.weight, clazz, m_weightScales[clazz][spec].info.name);
-        //     }
-        // }
-
-        // cacheInfo.team = TEAM_NEUTRAL;
-
-        // // check faction
-        // if (proto->HasFlag2(ITEM_FLAG2_FACTION_HORDE))
-        //     cacheInfo.team = TEAM_HORDE;
-
-        // if (proto->HasFlag2(ITEM_FLAG2_FACTION_ALLIANCE))
-        //     cacheInfo.team = TEAM_ALLIANCE;
-
-        // if (cacheInfo.team == TEAM_NEUTRAL && proto->AllowableRace > 1 && proto->AllowableRace < 8388607)
-        // {
-        //     if (FactionEntry const* faction = sFactionStore.LookupEntry(HORDE))
-        //         if ((proto->AllowableRace & faction->BaseRepRaceMask[0]) != 0)
-        //             cacheInfo.team = TEAM_HORDE;
-
-        //     if (FactionEntry const* faction = sFactionStore.LookupEntry(ALLIANCE))
-        //         if ((proto->AllowableRace & faction->BaseRepRaceMask[0]) != 0)
-        //             cacheInfo.team = TEAM_ALLIANCE;
-        // }
-
-        // if (cacheInfo.team < TEAM_NEUTRAL)
-        //     LOG_DEBUG("playerbots", "Item: {}, team (item): {}", proto->ItemId, cacheInfo.team == TEAM_ALLIANCE ?
-        //     "Alliance" : "Horde");
-
-        // // check min level
-        // if (proto->RequiredLevel)
-        //     cacheInfo.minLevel = proto->RequiredLevel;
-
-        // // check item source
-
-        // if (proto->HasFlag(ITEM_FLAG_NO_DISENCHANT))
-        // {
-        //     cacheInfo.source = ITEM_SOURCE_PVP;
-        //     LOG_DEBUG("playerbots", "Item: {}, source: PvP Reward", proto->ItemId);
-        // }
-
-        // // check quests
-        // if (cacheInfo.source == ITEM_SOURCE_NONE)
-        // {
-        //     std::vector<uint32> questIds = GetQuestIdsForItem(proto->ItemId);
-        //     if (questIds.size())
-        //     {
-        //         bool isAlly = false;
-        //         bool isHorde = false;
-        //         for (std::vector<uint32>::iterator i = questIds.begin(); i != questIds.end(); ++i)
-        //         {
-        //             Quest const* quest = sObjectMgr->GetQuestTemplate(*i);
-        //             if (quest)
-        //             {
-        //                 cacheInfo.source = ITEM_SOURCE_QUEST;
-        //                 cacheInfo.sourceId = *i;
-        //                 if (!cacheInfo.minLevel)
-        //                     cacheInfo.minLevel = quest->GetMinLevel();
-
-        //                 // check quest team
-        //                 if (cacheInfo.team == TEAM_NEUTRAL)
-        //                 {
-        //                     uint32 reqRace = quest->GetAllowableRaces();
-        //                     if (reqRace)
-        //                     {
-        //                         if ((reqRace & RACEMASK_ALLIANCE) != 0)
-        //                             isAlly = true;
-        //                         else if ((reqRace & RACEMASK_HORDE) != 0)
-        //                             isHorde = true;
-        //                     }
-        //                 }
-        //             }
-        //         }
-
-        //         if (isAlly && isHorde)
-        //             cacheInfo.team = TEAM_NEUTRAL;
-        //         else if (isAlly)
-        //             cacheInfo.team = TEAM_ALLIANCE;
-        //         else if (isHorde)
-        //             cacheInfo.team = TEAM_HORDE;
-
-        //         LOG_DEBUG("playerbots", "Item: {}, team (quest): {}", proto->ItemId, cacheInfo.team == TEAM_ALLIANCE
-        //         ? "Alliance" : cacheInfo.team == TEAM_HORDE ? "Horde" : "Both"); LOG_DEBUG("playerbots", "Item: {},
-        //         source: quest {}, minlevel: {}", proto->ItemId, cacheInfo.sourceId, cacheInfo.minLevel);
-        //     }
-        // }
-
-        // if (cacheInfo.minLevel)
-        //     LOG_DEBUG("playerbots", "Item: {}, minlevel: {}", proto->ItemId, cacheInfo.minLevel);
-
-        // // check vendors
-        // if (cacheInfo.source == ITEM_SOURCE_NONE)
-        // {
-        //     for (std::set<uint32>::iterator i = vendorItems.begin(); i != vendorItems.end(); ++i)
-        //     {
-        //         if (proto->ItemId == *i)
-        //         {
-        //             cacheInfo.source = ITEM_SOURCE_VENDOR;
-        //             LOG_DEBUG("playerbots", "Item: {} source: vendor", proto->ItemId);
-        //             break;
-        //         }
-        //     }
-        // }
-
-        // // check drops
-        // std::vector<int32> creatures;
-        // std::vector<int32> gameobjects;
-        // auto range = dropMap->equal_range(itr.first);
-
-        // for (auto iter = range.first; iter != range.second; ++iter)
-        // {
-        //     if (iter->second > 0)
-        //         creatures.push_back(iter->second);
-        //     else
-        //         gameobjects.push_back(abs(iter->second));
-        // }
-
-        // // check creature drop
-        // if (cacheInfo.source == ITEM_SOURCE_NONE)
-        // {
-        //     if (creatures.size())
-        //     {
-        //         if (creatures.size() == 1)
-        //         {
-        //             cacheInfo.source = ITEM_SOURCE_DROP;
-        //             cacheInfo.sourceId = creatures.front();
-        //             LOG_DEBUG("playerbots", "Item: {}, source: creature drop, ID: {}", proto->ItemId,
-        //             creatures.front());
-        //         }
-        //         else
-        //         {
-        //             cacheInfo.source = ITEM_SOURCE_DROP;
-        //             LOG_DEBUG("playerbots", "Item: {}, source: creatures drop, number: {}", proto->ItemId,
-        //             creatures.size());
-        //         }
-        //     }
-        // }
+    }
 
-        // // check gameobject drop
-        // if (cacheInfo.source == ITEM_SOURCE_NONE || (cacheInfo.source == ITEM_SOURCE_DROP && !cacheInfo.sourceId))
-        // {
-        //     if (gameobjects.size())
-        //     {
-        //         if (gameobjects.size() == 1)
-        //         {
-        //             cacheInfo.source = ITEM_SOURCE_DROP;
-        //             cacheInfo.sourceId = gameobjects.front();
-        //             LOG_INFO("playerbots", "Item: {}, source: gameobject, ID: {}", proto->ItemId,
-        //             gameobjects.front());
-        //         }
-        //         else
-        //         {
-        //             cacheInfo.source = ITEM_SOURCE_DROP;
-        //             LOG_INFO("playerbots", "Item: {}, source: gameobjects, number: {}", proto->ItemId,
-        //             gameobjects.size());
-        //         }
-        //     }
-        // }
-
-        // // check faction
-        // if (proto->RequiredReputationFaction > 0 && proto->RequiredReputationFaction != 35 &&
-        // proto->RequiredReputationRank < 15)
-        // {
-        //     cacheInfo.repFaction = proto->RequiredReputationFaction;
-        //     cacheInfo.repRank = proto->RequiredReputationRank;
-        // }
-
-        // cacheInfo.quality = proto->Quality;
-        // cacheInfo.itemId = proto->ItemId;
-        // cacheInfo.slot = slot;
-
-        // // save cache
-        // PlayerbotsDatabasePreparedStatement* stmt =
-        // PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_DEL_EQUIP_CACHE_NEW); stmt->SetData(0, proto->ItemId);
-        // trans->Append(stmt);
-
-        // stmt = PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_INS_EQUIP_CACHE_NEW);
-        // stmt->SetData(0, cacheInfo.itemId);
-        // stmt->SetData(1, cacheInfo.quality);
-        // stmt->SetData(2, cacheInfo.slot);
-        // stmt->SetData(3, cacheInfo.source);
-        // stmt->SetData(4, cacheInfo.sourceId);
-        // stmt->SetData(5, cacheInfo.team);
-        // stmt->SetData(6, cacheInfo.repFaction);
-        // stmt->SetData(7, cacheInfo.repRank);
-        // stmt->SetData(8, cacheInfo.minLevel);
-
-        // for (uint8 i = 1; i <= MAX_STAT_SCALES; ++i)
-        // {
-        //     if (cacheInfo.weights[i])
-        //         stmt->SetData(8 + i, cacheInfo.weights[i]);
-        //     else
-        //         stmt->SetData(8 + i, 0);
-        // }
-
-        // trans->Append(stmt);
-
-        // itemInfoCache[cacheInfo.itemId] = std::move(cacheInfo);
-    }
-
-    PlayerbotsDatabase.CommitTransaction(trans);
+    LOG_INFO("playerbots", "Found {} test or deprecated items", itemForTest.size());
 }
 
 uint32 RandomItemMgr::CalculateStatWeight(uint8 playerclass, uint8 spec, ItemTemplate const* proto)
@@ -2200,6 +2168,7 @@ void RandomItemMgr::BuildEquipCacheNew()
 {
     LOG_INFO("playerbots", "Loading equipments cache...");
 
+    FlatItemTable::Rows equipments;
     std::unordered_set<uint32> questItemIds;
     ObjectMgr::QuestMap const& questTemplates = sObjectMgr->GetQuestTemplates();
     for (ObjectMgr::QuestMap::const_iterator i = questTemplates.begin(); i != questTemplates.end(); ++i)
@@ -2223,7 +2192,7 @@ void RandomItemMgr::BuildEquipCacheNew()
                 if (proto->Class != ITEM_CLASS_WEAPON && proto->Class != ITEM_CLASS_ARMOR)
                     continue;
                 int requiredLevel = std::max((int)proto->RequiredLevel, quest->GetQuestLevel());
-                equipCacheNew[requiredLevel][proto->InventoryType].push_back(itemId);
+                equipments[requiredLevel][proto->InventoryType].push_back(itemId);
                 questItemIds.insert(itemId);
             }
 
@@ -2234,7 +2203,7 @@ void RandomItemMgr::BuildEquipCacheNew()
                 if (proto->Class != ITEM_CLASS_WEAPON && proto->Class != ITEM_CLASS_ARMOR)
                     continue;
                 int requiredLevel = std::max((int)proto->RequiredLevel, quest->GetQuestLevel());
-                equipCacheNew[requiredLevel][proto->InventoryType].push_back(itemId);
+                equipments[requiredLevel][proto->InventoryType].push_back(itemId);
                 questItemIds.insert(itemId);
             }
     }
@@ -2258,8 +2227,10 @@ void RandomItemMgr::BuildEquipCacheNew()
         if (sPlayerbotAIConfig.unobtainableItems.find(itemId) != sPlayerbotAIConfig.unobtainableItems.end())
             continue;
 
-        equipCacheNew[proto->RequiredLevel][proto->InventoryType].push_back(itemId);
+        equipments[proto->RequiredLevel][proto->InventoryType].push_back(itemId);
     }
+
+    equipCacheNew.Assign(equipments);
 }
 
 RandomItemList RandomItemMgr::Query(uint32 level, uint8 clazz, uint8 slot, uint32 quality)
@@ -2305,6 +2276,7 @@ void RandomItemMgr::BuildAmmoCache()
 
     LOG_INFO("server.loading", "Building ammo cache for {} levels", maxLevel);
 
+    FlatItemTable::Rows ammo;
     uint32 counter = 0;
     for (uint32 level = 1; level <= maxLevel; level += 1)
     {
@@ -2321,16 +2293,21 @@ void RandomItemMgr::BuildAmmoCache()
             {
                 Field* fields = results->Fetch();
                 uint32 entry = fields[0].Get<uint32>();
-                ammoCache[level][subClass].push_back(entry);
+                ammo[level][subClass].push_back(entry);
                 ++counter;
             } while (results->NextRow());
         }
     }
 
+    ammoCache.Assign(ammo);
+
     LOG_INFO("server.loading", "Cached {} ammo", counter);  // TEST
 }
 
-std::vector<uint32> RandomItemMgr::GetAmmo(uint32 level, uint32 subClass) { return ammoCache[level][subClass]; }
+std::span<uint32 const> RandomItemMgr::GetAmmo(uint32 level, uint32 subClass) const
+{
+    return ammoCache.Get(level, subClass);
+}
 
 void RandomItemMgr::BuildPotionCache()
 {
@@ -2340,6 +2317,7 @@ void RandomItemMgr::BuildPotionCache()
 
     ItemTemplateContainer const* itemTemplates = sObjectMgr->GetItemTemplateStore();
 
+    FlatItemTable::Rows potions;
     uint32 counter = 0;
     for (uint32 level = 1; level <= maxLevel; level++)
     {
@@ -2392,7 +2370,7 @@ void RandomItemMgr::BuildPotionCache()
                     continue;
 
                 if (spellInfo->Effects[0].Effect == effect)
-                    potionCache[level][effect].push_back(itr.first);
+                    potions[level][effect].push_back(itr.first);
             }
         }
     }
@@ -2403,11 +2381,13 @@ void RandomItemMgr::BuildPotionCache()
         for (uint8 i = 0; i < 2; ++i)
         {
             uint32 effect = effects[i];
-            uint32 size = potionCache[level][effect].size();
+            uint32 size = potions[level][effect].size();
             counter += size;
         }
     }
 
+    potionCache.Assign(potions);
+
     LOG_INFO("playerbots", "Cached {} potions", counter);
 }
 
@@ -2421,6 +2401,7 @@ void RandomItemMgr::BuildFoodCache()
 
     ItemTemplateContainer const* itemTemplates = sObjectMgr->GetItemTemplateStore();
 
+    FlatItemTable::Rows food;
     uint32 counter = 0;
     for (uint32 level = 1; level <= maxLevel + 1; level += 10)
     {
@@ -2452,7 +2433,7 @@ void RandomItemMgr::BuildFoodCache()
                 if (proto->Duration & 0x80000000)
                     continue;
 
-                foodCache[level / 10][category].push_back(itr.first);
+                food[level / 10][category].push_back(itr.first);
             }
         }
     }
@@ -2463,18 +2444,20 @@ void RandomItemMgr::BuildFoodCache()
         for (uint8 i = 0; i < 2; ++i)
         {
             uint32 category = categories[i];
-            uint32 size = foodCache[level / 10][category].size();
+            uint32 size = food[level / 10][category].size();
             ++counter;
             LOG_DEBUG("server.loading", "Food cache for level={}, category={}: {} items", level, category, size);
         }
     }
 
+    foodCache.Assign(food);
+
     LOG_INFO("server.loading", "Cached {} types of food", counter);
 }
 
 uint32 RandomItemMgr::GetRandomPotion(uint32 level, uint32 effect)
 {
-    const std::vector<uint32> &potions = potionCache[level][effect];
+    std::span<uint32 const> potions = potionCache.Get(level, effect);
     if (potions.empty())
         return 0;
 
@@ -2537,7 +2520,7 @@ uint32 RandomItemMgr::GetFood(uint32 level, uint32 category)
 
 uint32 RandomItemMgr::GetRandomFood(uint32 level, uint32 category)
 {
-    std::vector<uint32> food = foodCache[(level - 1) / 10][category];
+    std::span<uint32 const> food = foodCache.Get((level - 1) / 10, category);
     if (food.empty())
         return 0;
 
@@ -2554,6 +2537,7 @@ void RandomItemMgr::BuildTradeCache()
 
     ItemTemplateContainer const* itemTemplates = sObjectMgr->GetItemTemplateStore();
 
+    FlatItemTable::Rows trade;
     uint32 counter = 0;
     for (uint32 level = 1; level <= maxLevel + 1; level += 10)
     {
@@ -2575,23 +2559,25 @@ void RandomItemMgr::BuildTradeCache()
             if (proto->RequiredSkill)
                 continue;
 
-            tradeCache[level / 10].push_back(itr.first);
+            trade[level / 10][0].push_back(itr.first);
         }
     }
 
     for (uint32 level = 1; level <= maxLevel + 1; level += 10)
     {
-        uint32 size = tradeCache[level / 10].size();
+        uint32 size = trade[level / 10][0].size();
         LOG_DEBUG("server.loading", "Trade cache for level={}: {} items", level, size);
         ++counter;
     }
 
+    tradeCache.Assign(trade);
+
     LOG_INFO("server.loading", "Cached {} trade items", counter);  // TEST
 }
 
 uint32 RandomItemMgr::GetRandomTrade(uint32 level)
 {
-    std::vector<uint32> trade = tradeCache[(level - 1) / 10];
+    std::span<uint32 const> trade = tradeCache.Get((level - 1) / 10);
     if (trade.empty())
         return 0;
 
@@ -2600,6 +2586,9 @@ uint32 RandomItemMgr::GetRandomTrade(uint32 level)
 
 void RandomItemMgr::BuildRarityCache()
 {
+    // the fast template store is indexed by item id, so its size bounds the ids
+    rarityCache.assign(sObjectMgr->GetItemTemplateStoreFast()->size(), 0.0f);
+
     if (PreparedQueryResult result =
             PlayerbotsDatabase.Query(PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_SEL_RARITY_CACHE)))
     {
@@ -2612,7 +2601,8 @@ void RandomItemMgr::BuildRarityCache()
             uint32 itemId = fields[0].Get<uint32>();
             float rarity = fields[1].Get<float>();
 
-            rarityCache[itemId] = rarity;
+            if (itemId < rarityCache.size())
+                rarityCache[itemId] = rarity;
             ++count;
 
         } while (result->NextRow());
@@ -2754,7 +2744,10 @@ void RandomItemMgr::BuildRarityCache()
     }
 }
 
-float RandomItemMgr::GetItemRarity(uint32 itemId) { return rarityCache[itemId]; }
+float RandomItemMgr::GetItemRarity(uint32 itemId) const
+{
+    return itemId < rarityCache.size() ? rarityCache[itemId] : 0.0f;
+}
 
 inline bool IsCraftedBySpellInfo(ItemTemplate const* proto, SpellInfo const* spellInfo)
 {
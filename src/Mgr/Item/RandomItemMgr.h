@@ -8,10 +8,12 @@
 
 #include <map>
 #include <set>
+#include <span>
 #include <unordered_set>
 #include <vector>
 
 #include "AiFactory.h"
+#include "FlatItemTable.h"
 #include "ItemTemplate.h"
 
 class ChatHandler;
@@ -155,7 +157,7 @@ public:
     uint32 GetStatWeight(Player* player, uint32 itemId);
     uint32 GetLiveStatWeight(Player* player, uint32 itemId);
     uint32 GetRandomItem(uint32 level, RandomItemType type, RandomItemPredicate* predicate = nullptr);
-    std::vector<uint32> GetAmmo(uint32 level, uint32 subClass);
+    std::span<uint32 const> GetAmmo(uint32 level, uint32 subClass) const;
     uint32 GetRandomPotion(uint32 level, uint32 effect);
     uint32 GetRandomFood(uint32 level, uint32 category);
     uint32 GetFood(uint32 level, uint32 category);
@@ -166,18 +168,19 @@ public:
     bool ShouldEquipArmorForSpec(uint8 playerclass, uint8 spec, ItemTemplate const* proto);
     bool CanEquipWeapon(uint8 clazz, ItemTemplate const* proto);
     bool ShouldEquipWeaponForSpec(uint8 playerclass, uint8 spec, ItemTemplate const* proto);
-    float GetItemRarity(uint32 itemId);
+    float GetItemRarity(uint32 itemId) const;
     uint32 GetQuestIdForItem(uint32 itemId);
     std::vector<uint32> GetQuestIdsForItem(uint32 itemId);
     static bool IsUsedBySkill(ItemTemplate const* proto, uint32 skillId);
     bool IsTestItem(uint32 itemId) { return itemForTest.find(itemId) != itemForTest.end(); }
-    std::vector<uint32> GetCachedEquipments(uint32 requiredLevel, uint32 inventoryType);
+    std::span<uint32 const> GetCachedEquipments(uint32 requiredLevel, uint32 inventoryType) const;
 
 private:
     void BuildRandomItemCache();
     void BuildEquipCache();
     void BuildEquipCacheNew();
     void BuildItemInfoCache();
+    void BuildTestItemCache();
     void BuildAmmoCache();
     void BuildFoodCache();
     void BuildPotionCache();
@@ -187,6 +190,9 @@ private:
     bool CanEquipItemNew(ItemTemplate const* proto);
     void AddItemStats(uint32 mod, uint8& sp, uint8& ap, uint8& tank);
     bool CheckItemStats(uint8 clazz, uint8 sp, uint8 ap, uint8 tank);
+    uint64 GetSnapshotKey() const;
+    bool LoadSnapshot(std::string const& path, uint64 key);
+    void SaveSnapshot(std::string const& path, uint64 key) const;
 
 private:
     // Implemented in RandomItemMgr.cpp
@@ -204,19 +210,18 @@ private:
     std::map<RandomItemType, RandomItemPredicate*> predicates;
     BotEquipCache equipCache;
     std::map<EquipmentSlots, std::set<InventoryType>> viableSlots;
-    std::map<uint32, std::map<uint32, std::vector<uint32>>> ammoCache;
-    std::map<uint32, std::map<uint32, std::vector<uint32>>> potionCache;
-    std::map<uint32, std::map<uint32, std::vector<uint32>>> foodCache;
-    std::map<uint32, std::vector<uint32>> tradeCache;
-    std::map<uint32, float> rarityCache;
+    FlatItemTable ammoCache;    // [level][subClass]
+    FlatItemTable potionCache;  // [level][effect]
+    FlatItemTable foodCache;    // [level / 10][category]
+    FlatItemTable tradeCache;   // [level / 10]
+    std::vector<float> rarityCache;  // indexed by item id
     std::map<uint8, WeightScale> m_weightScales[MAX_CLASSES];
     std::map<std::string, uint32> weightStatLink;
     std::map<std::string, uint32> weightRatingLink;
     std::map<uint32, ItemInfoEntry> itemInfoCache;
     std::unordered_set<uint32> itemForTest;
     static std::set<uint32> itemCache;
-    // equipCacheNew[RequiredLevel][InventoryType]
-    std::map<uint32, std::map<uint32, std::vector<uint32>>> equipCacheNew;
+    FlatItemTable equipCacheNew;  // [RequiredLevel][InventoryType]
 };
 
 #define sRandomItemMgr RandomItemMgr::instance()
@@ -792,8 +792,16 @@ std::vector<WorldPosition> WorldPosition::getPathStepFrom(WorldPosition startPos
     // Load mmaps and vmaps between the two points.
     loadMapAndVMaps(startPos);
 
+    // Units generating travel node paths are not in the world, they are moved to the start of every step.
+    bool const pathingUnit = !bot->IsInWorld();
+    if (pathingUnit)
+        bot->Relocate(startPos.GetPositionX(), startPos.GetPositionY(), startPos.GetPositionZ());
+
     PathGenerator path(bot);
-    path.CalculatePath(startPos.GetPositionX(), startPos.GetPositionY(), startPos.GetPositionZ());
+    if (pathingUnit)
+        path.CalculatePath(GetPositionX(), GetPositionY(), GetPositionZ());
+    else
+        path.CalculatePath(startPos.GetPositionX(), startPos.GetPositionY(), startPos.GetPositionZ());
 
     Movement::PointsArray points = path.GetPath();
     PathType type = path.GetPathType();
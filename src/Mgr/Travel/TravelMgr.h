@@ -8,6 +8,7 @@
 
 #include <boost/functional/hash.hpp>
 #include <map>
+#include <mutex>
 #include <random>
 
 #include "AiObject.h"
@@ -912,17 +913,28 @@ public:
     NullTravelDestination* nullTravelDestination = new NullTravelDestination();
     WorldPosition* nullWorldPosition = new WorldPosition();
 
-    void addBadVmap(uint32 mapId, uint8 x, uint8 y) { badVmap.push_back(std::make_tuple(mapId, x, y)); }
+    // The bad map lists are shared by the walk path generation workers
+    void addBadVmap(uint32 mapId, uint8 x, uint8 y)
+    {
+        std::lock_guard<std::mutex> guard(badMapLock);
+        badVmap.push_back(std::make_tuple(mapId, x, y));
+    }
 
-    void addBadMmap(uint32 mapId, uint8 x, uint8 y) { badMmap.push_back(std::make_tuple(mapId, x, y)); }
+    void addBadMmap(uint32 mapId, uint8 x, uint8 y)
+    {
+        std::lock_guard<std::mutex> guard(badMapLock);
+        badMmap.push_back(std::make_tuple(mapId, x, y));
+    }
 
     bool isBadVmap(uint32 mapId, uint8 x, uint8 y)
     {
+        std::lock_guard<std::mutex> guard(badMapLock);
         return std::find(badVmap.begin(), badVmap.end(), std::make_tuple(mapId, x, y)) != badVmap.end();
     }
 
     bool isBadMmap(uint32 mapId, uint8 x, uint8 y)
     {
+        std::lock_guard<std::mutex> guard(badMapLock);
         return std::find(badMmap.begin(), badMmap.end(), std::make_tuple(mapId, x, y)) != badMmap.end();
     }
 
@@ -942,6 +954,7 @@ public:
     std::unordered_map<uint32, QuestContainer*> quests;
 
     std::vector<std::tuple<uint32, uint8, uint8>> badVmap, badMmap;
+    std::mutex badMapLock;
 
     std::unordered_map<std::pair<uint32, uint32>, std::vector<mapTransfer>, boost::hash<std::pair<uint32, uint32>>>
         mapTransfersMap;
@@ -5,16 +5,282 @@
 
 #include "TravelNode.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
 #include <iomanip>
+#include <memory>
+#include <random>
 #include <regex>
 #include <unordered_set>
 
 #include "BudgetValues.h"
+#include "Chat.h"
+#include "Creature.h"
+#include "MapMgr.h"
 #include "PathGenerator.h"
 #include "Playerbots.h"
 #include "RaceMgr.h"
 #include "ServerFacade.h"
 #include "TransportMgr.h"
+#include "TravelNodeSnapshot.h"
+#include "World.h"
+
+namespace
+{
+    // Stubs of the route searches of one thread, reused from search to search. Nodes of the node list use
+    // their search index as slot, other nodes (portal and bot position nodes) get slots past the list.
+    // Stubs are stamped with the search they were reset for, so a new search does not clear them.
+    class RouteSearchArena
+    {
+    public:
+        void Begin(std::vector<TravelNode*> const& nodeList)
+        {
+            nodes = &nodeList;
+            stubs.resize(nodeList.size());
+            extras.clear();
+            open.clear();
+
+            if (++generation == 0)
+            {
+                for (TravelNodeStub& stub : stubs)
+                    stub.generation = 0;
+
+                generation = 1;
+            }
+        }
+
+        // Slot of the stub of the node, the stub is reset when first used in this search
+        uint32 Slot(TravelNode* node)
+        {
+            uint32 slot = node->getSearchIndex();
+            if (slot >= nodes->size() || (*nodes)[slot] != node)
+            {
+                auto extra = std::find_if(extras.begin(), extras.end(),
+                                          [node](std::pair<TravelNode*, uint32> const& e) { return e.first == node; });
+                if (extra != extras.end())
+                    slot = extra->second;
+                else
+                {
+                    slot = stubs.size();
+                    stubs.emplace_back();
+                    extras.emplace_back(node, slot);
+                }
+            }
+
+            TravelNodeStub& stub = stubs[slot];
+            if (stub.generation != generation)
+            {
+                stub = TravelNodeStub(node);
+                stub.generation = generation;
+            }
+
+            return slot;
+        }
+
+        TravelNodeStub& operator[](uint32 slot) { return stubs[slot]; }
+
+        void Push(uint32 slot)
+        {
+            open.emplace_back(stubs[slot].m_f, slot);
+            std::push_heap(open.begin(), open.end(), Later);
+        }
+
+        // Pops the open stub with the lowest f, skipping entries of stubs improved or closed since
+        bool Pop(uint32& slot)
+        {
+            while (!open.empty())
+            {
+                std::pair<float, uint32> const top = open.front();
+                std::pop_heap(open.begin(), open.end(), Later);
+                open.pop_back();
+
+                TravelNodeStub const& stub = stubs[top.second];
+                if (!stub.open || stub.m_f != top.first)
+                    continue;
+
+                slot = top.second;
+                return true;
+            }
+
+            return false;
+        }
+
+    private:
+        static bool Later(std::pair<float, uint32> const& a, std::pair<float, uint32> const& b)
+        {
+            return a.first > b.first;
+        }
+
+        std::vector<TravelNode*> const* nodes = nullptr;
+        std::vector<TravelNodeStub> stubs;
+        std::vector<std::pair<TravelNode*, uint32>> extras;
+        std::vector<std::pair<float, uint32>> open;  // (f, slot)
+        uint32 generation = 0;
+    };
+
+    thread_local RouteSearchArena routeSearchArena;
+
+    // Bot attributes changing link costs, bots with the same profile share cached routes
+    uint32 GetRouteProfile(Player* bot, uint32 gold)
+    {
+        if (!bot)
+            return 0;
+
+        uint32 goldBucket = 0;
+        for (uint32 coins = gold / GOLD; coins; coins >>= 1)
+            ++goldBucket;
+
+        uint32 const speed = std::min(uint32(bot->GetSpeed(MOVE_RUN) * 2.0f), uint32(0xFF));
+
+        return 1 | (bot->GetTeamId() == TEAM_ALLIANCE ? 1 << 1 : 0) | (bot->isTaxiCheater() ? 1 << 2 : 0) |
+               (bot->IsAlive() ? 1 << 3 : 0) | (bot->HasSpell(1066) ? 1 << 4 : 0) | (goldBucket << 5) |
+               (uint32(bot->GetLevel()) << 10) | (speed << 18);
+    }
+
+    // Whether the bot can still travel every link of the route
+    bool IsRouteUsable(std::vector<TravelNode*> const& path, Player* bot, uint32 gold)
+    {
+        for (size_t i = 1; i < path.size(); ++i)
+        {
+            auto link = path[i - 1]->getLinks()->find(path[i]);
+            if (link == path[i - 1]->getLinks()->end())
+                return false;
+
+            if (link->second->getCost(bot, gold) <= 0)
+                return false;
+
+            if (bot && !bot->isTaxiCheater())
+                gold -= link->second->getPrice();
+        }
+
+        return true;
+    }
+
+    // Fingerprint of the node store tables. CHECKSUM TABLE covers every column of every row, a node name or a
+    // path point edited in the tables changes the key where sums over some columns could miss it.
+    bool GetNodeStoreKey(uint64& key)
+    {
+        QueryResult result = PlayerbotsDatabase.Query(
+            "CHECKSUM TABLE playerbots_travelnode, playerbots_travelnode_link, playerbots_travelnode_path");
+        if (!result)
+            return false;
+
+        key = 0xCBF29CE484222325ULL;  // FNV-1a
+        do
+        {
+            Field* fields = result->Fetch();
+
+            // missing tables have no checksum
+            if (fields[1].IsNull())
+                return false;
+
+            for (char c : fields[0].Get<std::string>() + "|" + std::to_string(fields[1].Get<uint64>()) + "|")
+            {
+                key ^= uint8(c);
+                key *= 0x100000001B3ULL;
+            }
+        } while (result->NextRow());
+
+        return true;
+    }
+
+    // Walking creature (Stormwind City Guard) standing in for a player when paths are generated
+    constexpr uint32 PATHING_UNIT_ENTRY = 68;
+
+    // Side of the regions walk paths are generated and checkpointed by, the range of the walk links
+    constexpr float WALK_REGION_SIZE = 2000.0f;
+
+    // Unit running the PathGenerator of a walk path worker. It is created on the base map but never added to it.
+    std::unique_ptr<Creature> CreatePathingUnit(uint32 mapId, WorldPosition const& pos)
+    {
+        MapEntry const* mapEntry = sMapStore.LookupEntry(mapId);
+        if (!mapEntry || mapEntry->Instanceable())
+            return nullptr;
+
+        Map* map = sMapMgr->CreateBaseMap(mapId);
+        if (!map)
+            return nullptr;
+
+        std::unique_ptr<Creature> unit = std::make_unique<Creature>();
+        if (!unit->Create(map->GenerateLowGuid<HighGuid::Unit>(), map, PHASEMASK_NORMAL, PATHING_UNIT_ENTRY, 0,
+                          pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), 0.0f))
+            return nullptr;
+
+        return unit;
+    }
+
+    // Appends the links and path points of a node, ids are the node indexes of the saved store
+    void AppendNodeLinks(PlayerbotsDatabaseTransaction trans, TravelNode* node, uint32 id,
+                         std::unordered_map<TravelNode*, uint32> const& nodeIds, uint32& paths, uint32& points)
+    {
+        for (auto& link : *node->getLinks())
+        {
+            TravelNodePath* path = link.second;
+            uint32 const toId = nodeIds.find(link.first)->second;
+
+            PlayerbotsDatabasePreparedStatement* stmt =
+                PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_INS_TRAVELNODE_LINK);
+            stmt->SetData(0, id);
+            stmt->SetData(1, toId);
+            stmt->SetData(2, static_cast<uint8>(path->getPathType()));
+            stmt->SetData(3, path->getPathObject());
+            stmt->SetData(4, path->getDistance());
+            stmt->SetData(5, path->getSwimDistance());
+            stmt->SetData(6, path->getExtraCost());
+            stmt->SetData(7, path->getCalculated());
+            stmt->SetData(8, path->getMaxLevelCreature()[0]);
+            stmt->SetData(9, path->getMaxLevelCreature()[1]);
+            stmt->SetData(10, path->getMaxLevelCreature()[2]);
+            trans->Append(stmt);
+
+            paths++;
+
+            std::vector<WorldPosition> ppath = path->getPath();
+
+            for (uint32 j = 0; j < ppath.size(); j++)
+            {
+                WorldPosition point = ppath[j];
+
+                PlayerbotsDatabasePreparedStatement* stmt =
+                    PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_INS_TRAVELNODE_PATH);
+                stmt->SetData(0, id);
+                stmt->SetData(1, toId);
+                stmt->SetData(2, j);
+                stmt->SetData(3, point.GetMapId());
+                stmt->SetData(4, point.GetPositionX());
+                stmt->SetData(5, point.GetPositionY());
+                stmt->SetData(6, point.GetPositionZ());
+                trans->Append(stmt);
+
+                points++;
+            }
+        }
+    }
+
+    // Rewrites the links, path points and linked flag of the nodes in the saved store
+    void CheckpointNodes(std::unordered_set<TravelNode*> const& nodes,
+                         std::unordered_map<TravelNode*, uint32> const& nodeIds)
+    {
+        PlayerbotsDatabaseTransaction trans = PlayerbotsDatabase.BeginTransaction();
+
+        uint32 paths = 0, points = 0;
+        for (TravelNode* node : nodes)
+        {
+            uint32 const id = nodeIds.find(node)->second;
+
+            trans->Append("DELETE FROM playerbots_travelnode_link WHERE node_id = {}", id);
+            trans->Append("DELETE FROM playerbots_travelnode_path WHERE node_id = {}", id);
+            trans->Append("UPDATE playerbots_travelnode SET linked = {} WHERE id = {}", node->isLinked() ? 1 : 0, id);
+
+            AppendNodeLinks(trans, node, id, nodeIds, paths, points);
+        }
+
+        PlayerbotsDatabase.DirectCommitTransaction(trans);
+    }
+}
 
 // TravelNodePath(float distance = 0.1f, float extraCost = 0, TravelNodePathType pathType = TravelNodePathType::walk,
 // uint32 pathObject = 0, bool calculated = false, std::vector<uint8> maxLevelCreature = { 0,0,0 }, float swimDistance =
@@ -186,6 +452,33 @@ uint32 TravelNodePath::getPrice()
     return taxiPath->price;
 }
 
+TravelNodePath* TravelNode::setPathTo(TravelNode* node, TravelNodePath path, bool isLink)
+{
+    if (this == node)
+        return nullptr;
+
+    paths[node] = path;
+    if (isLink)
+        links[node] = &paths[node];
+
+    TravelNodeMap::instance().invalidateRoutes();
+    return &paths[node];
+}
+
+void TravelNode::setLinkTo(TravelNode* node, float distance)
+{
+    if (this == node)
+        return;
+
+    if (!hasPathTo(node))
+        setPathTo(node, TravelNodePath(distance));
+    else
+    {
+        links[node] = &paths[node];
+        TravelNodeMap::instance().invalidateRoutes();
+    }
+}
+
 // Creates or appends the path from one node to another. Returns if the path.
 TravelNodePath* TravelNode::buildPath(TravelNode* endNode, Unit* bot, bool postProcess)
 {
@@ -202,6 +495,9 @@ TravelNodePath* TravelNode::buildPath(TravelNode* endNode, Unit* bot, bool postP
     if (returnNodePath->getComplete())  // Path is already complete. Return it.
         return returnNodePath;
 
+    // The path, its cost and the reverse link are changed in place below
+    TravelNodeMap::instance().invalidateRoutes();
+
     std::vector<WorldPosition> path = returnNodePath->getPath();
 
     if (path.empty())
@@ -314,6 +610,8 @@ TravelNodePath* TravelNode::buildPath(TravelNode* endNode, Unit* bot, bool postP
 // Generic routine to remove references to nodes.
 void TravelNode::removeLinkTo(TravelNode* node, bool removePaths)
 {
+    TravelNodeMap::instance().invalidateRoutes();
+
     if (node)  // Unlink this specific node
     {
         if (removePaths)
@@ -1081,7 +1379,10 @@ TravelNode* TravelNodeMap::addNode(WorldPosition pos, std::string const prefered
 
     newNode = new TravelNode(pos, finalName, isImportant);
 
+    newNode->setSearchIndex(m_nodes.size());
     m_nodes.push_back(newNode);
+    m_nodeGrid.Insert(newNode, pos.GetMapId(), pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ());
+    routeCache.Clear();
 
     return newNode;
 }
@@ -1090,6 +1391,9 @@ void TravelNodeMap::removeNode(TravelNode* node)
 {
     node->removeLinkTo(nullptr, true);
 
+    m_nodeGrid.Remove(node, node->getMapId(), node->getX(), node->getY());
+    routeCache.Clear();
+
     for (auto& tnode : m_nodes)
     {
         if (tnode == node)
@@ -1100,6 +1404,9 @@ void TravelNodeMap::removeNode(TravelNode* node)
     }
 
     m_nodes.erase(std::remove(m_nodes.begin(), m_nodes.end(), nullptr), m_nodes.end());
+
+    for (uint32 i = 0; i < m_nodes.size(); ++i)
+        m_nodes[i]->setSearchIndex(i);
 }
 
 void TravelNodeMap::fullLinkNode(TravelNode* startNode, Unit* bot)
@@ -1124,20 +1431,13 @@ void TravelNodeMap::fullLinkNode(TravelNode* startNode, Unit* bot)
 
 std::vector<TravelNode*> TravelNodeMap::getNodes(WorldPosition pos, float range)
 {
-    std::vector<TravelNode*> retVec;
-
-    for (auto& node : m_nodes)
-    {
-        if (node->getMapId() == pos.GetMapId())
-            if (range == -1 || node->getDistance(pos) <= range)
-                retVec.push_back(node);
-    }
-
-    std::sort(retVec.begin(), retVec.end(),
-              [pos](TravelNode* i, TravelNode* j)
-              { return i->getPosition()->distance(pos) < j->getPosition()->distance(pos); });
+    return m_nodeGrid.Query(pos.GetMapId(), pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), range);
+}
 
-    return retVec;
+std::vector<TravelNode*> TravelNodeMap::getNearestNodes(WorldPosition pos, uint32 count, float range)
+{
+    return m_nodeGrid.Query(pos.GetMapId(), pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), range,
+                            count);
 }
 
 TravelNode* TravelNodeMap::getNode(WorldPosition pos, [[maybe_unused]] std::vector<WorldPosition>& ppath, Unit* bot,
@@ -1150,42 +1450,27 @@ TravelNode* TravelNodeMap::getNode(WorldPosition pos, [[maybe_unused]] std::vect
     if (bot && !bot->GetMap())
         return nullptr;
 
-    uint32 c = 0;
-
-    std::vector<TravelNode*> nodes = TravelNodeMap::instance().getNodes(pos, range);
+    // Max 6 attempts
+    std::vector<TravelNode*> nodes = TravelNodeMap::instance().getNearestNodes(pos, bot ? 6 : 1, range);
     for (auto& node : nodes)
     {
         if (!bot || pos.canPathTo(*node->getPosition(), bot))
             return node;
-
-        c++;
-
-        if (c > 5)  // Max 5 attempts
-            break;
     }
 
     return nullptr;
 }
 
-TravelNodeRoute TravelNodeMap::getRoute(TravelNode* start, TravelNode* goal, Player* bot)
+TravelNodeRoute TravelNodeMap::getRoute(TravelNode* start, TravelNode* goal, Player* bot, uint32* expansions)
 {
-    float botSpeed = bot ? bot->GetSpeed(MOVE_RUN) : 7.0f;
+    if (expansions)
+        *expansions = 0;
 
     if (start == goal)
         return TravelNodeRoute();
 
-    // Basic A* algoritm
-    std::unordered_map<TravelNode*, TravelNodeStub> m_stubs;
-
-    TravelNodeStub* startStub = &m_stubs.insert(std::make_pair(start, TravelNodeStub(start))).first->second;
-
-    TravelNodeStub* currentNode = nullptr;
-    TravelNodeStub* childNode = nullptr;
-    float f = 0.f;
-    float g = 0.f;
-    float h = 0.f;
-
-    std::vector<TravelNodeStub*> open, closed;
+    uint32 startGold = 0;
+    PortalNode* portNode = nullptr;
 
     if (bot)
     {
@@ -1193,15 +1478,15 @@ TravelNodeRoute TravelNodeMap::getRoute(TravelNode* start, TravelNode* goal, Pla
         if (botAI)
         {
             if (botAI->HasCheat(BotCheatMask::gold))
-                startStub->currentGold = 10000000;
+                startGold = 10000000;
             else
             {
                 AiObjectContext* context = botAI->GetAiObjectContext();
-                startStub->currentGold = AI_VALUE2(uint32, "free money for", (uint32)NeedMoneyFor::travel);
+                startGold = AI_VALUE2(uint32, "free money for", (uint32)NeedMoneyFor::travel);
             }
         }
         else
-            startStub->currentGold = bot->GetMoney();
+            startGold = bot->GetMoney();
 
         if (!bot->HasSpellCooldown(8690) && bot->IsAlive())
         {
@@ -1210,7 +1495,7 @@ TravelNodeRoute TravelNodeMap::getRoute(TravelNode* start, TravelNode* goal, Pla
             TravelNode* homeNode = TravelNodeMap::instance().getNode(AI_VALUE(WorldPosition, "home bind"), nullptr, 10.0f);
             if (homeNode)
             {
-                PortalNode* portNode = (PortalNode*)TravelNodeMap::instance().teleportNodes[bot->GetGUID()][8690];
+                portNode = (PortalNode*)TravelNodeMap::instance().teleportNodes[bot->GetGUID()][8690];
                 {
                     portNode = new PortalNode(start);
 
@@ -1218,101 +1503,141 @@ TravelNodeRoute TravelNodeMap::getRoute(TravelNode* start, TravelNode* goal, Pla
                 }
 
                 portNode->SetPortal(start, homeNode, 8690);
+            }
+        }
+    }
 
-                childNode = &m_stubs.insert(std::make_pair(portNode, TravelNodeStub(portNode))).first->second;
+    if (!portNode && !start->hasRouteTo(goal))
+        return TravelNodeRoute();
 
-                childNode->m_g = 10 * MINUTE;
-                childNode->m_h = childNode->dataNode->fDist(goal) / botSpeed;
-                childNode->m_f = childNode->m_g + childNode->m_h;
-                // childNode->parent = startStub;
+    auto const begin = std::chrono::steady_clock::now();
+    auto elapsed = [&begin]()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    };
 
-                open.push_back(childNode);
-                std::push_heap(open.begin(), open.end(),
-                               [](TravelNodeStub* i, TravelNodeStub* j) { return i->m_f < j->m_f; });
-                childNode->open = true;
-            }
+    // Routes through the hearthstone portal node belong to one bot and are not shared
+    uint32 const cacheSize = sPlayerbotAIConfig.travelRouteCacheSize;
+    bool const cacheable = cacheSize && !portNode && isListedNode(start) && isListedNode(goal);
+    TravelRouteCache::Key const key = {start, goal, GetRouteProfile(bot, startGold)};
+
+    std::vector<TravelNode*> path;
+    if (cacheable && routeCache.Get(key, path))
+    {
+        // the profile groups similar bots, the route is still checked against this one
+        if (IsRouteUsable(path, bot, startGold))
+        {
+            routeCache.AddQuery(true, elapsed());
+            return TravelNodeRoute(path);
         }
+
+        routeCache.Remove(key);
     }
 
-    if (open.size() == 0 && !start->hasRouteTo(goal))
-        return TravelNodeRoute();
+    // taken before the search, a route found while links change is not stored
+    uint32 const generation = routeCache.GetGeneration();
+    path = searchRoute(start, goal, bot, startGold, portNode, expansions);
 
-    std::make_heap(open.begin(), open.end(), [](TravelNodeStub* i, TravelNodeStub* j) { return i->m_f < j->m_f; });
+    if (cacheable && !path.empty() &&
+        std::all_of(path.begin(), path.end(), [this](TravelNode* node) { return isListedNode(node); }))
+        routeCache.Put(key, path, cacheSize, generation);
 
-    open.push_back(startStub);
-    std::push_heap(open.begin(), open.end(), [](TravelNodeStub* i, TravelNodeStub* j) { return i->m_f < j->m_f; });
-    startStub->open = true;
+    routeCache.AddQuery(false, elapsed());
+    return TravelNodeRoute(path);
+}
 
-    while (!open.empty())
+std::vector<TravelNode*> TravelNodeMap::searchRoute(TravelNode* start, TravelNode* goal, Player* bot,
+                                                    uint32 startGold, PortalNode* portNode, uint32* expansions)
+{
+    float botSpeed = bot ? bot->GetSpeed(MOVE_RUN) : 7.0f;
+
+    // A* algoritm, the open list is a min-heap on f. Improved nodes are pushed again and the outdated
+    // entries are skipped when popped.
+    RouteSearchArena& arena = routeSearchArena;
+    arena.Begin(m_nodes);
+
+    if (portNode)
     {
-        std::sort(open.begin(), open.end(), [](TravelNodeStub* i, TravelNodeStub* j) { return i->m_f < j->m_f; });
+        uint32 const portSlot = arena.Slot(portNode);
+        TravelNodeStub& portStub = arena[portSlot];
 
-        currentNode = open.front();  // pop n node from open for which f is minimal
+        portStub.m_g = 10 * MINUTE;
+        portStub.m_h = portNode->fDist(goal) / botSpeed;
+        portStub.m_f = portStub.m_g + portStub.m_h;
+        portStub.open = true;
+        arena.Push(portSlot);
+    }
 
-        std::pop_heap(open.begin(), open.end(), [](TravelNodeStub* i, TravelNodeStub* j) { return i->m_f < j->m_f; });
-        open.pop_back();
-        currentNode->open = false;
+    uint32 const startSlot = arena.Slot(start);
+    arena[startSlot].currentGold = startGold;
+    arena[startSlot].m_f = 0.0f;
+    arena[startSlot].open = true;
+    arena.Push(startSlot);
 
-        currentNode->close = true;
-        closed.push_back(currentNode);
+    uint32 expanded = 0;
+    uint32 currentSlot = 0;
+    while (arena.Pop(currentSlot))
+    {
+        ++expanded;
 
-        if (currentNode->dataNode == goal ||
-            (currentNode->dataNode->getMapId() != start->getMapId() && currentNode->dataNode->isWalking()))
-        {
-            TravelNodeStub* parent = currentNode->parent;
+        TravelNodeStub& currentStub = arena[currentSlot];
+        currentStub.open = false;
+        currentStub.close = true;
 
-            std::vector<TravelNode*> path;
-            path.push_back(currentNode->dataNode);
+        TravelNode* currentNode = currentStub.dataNode;
+        float const currentG = currentStub.m_g;
+        uint32 const currentGold = currentStub.currentGold;
 
-            while (parent != nullptr)
-            {
-                path.push_back(parent->dataNode);
-                parent = parent->parent;
-            }
+        if (currentNode == goal || (currentNode->getMapId() != start->getMapId() && currentNode->isWalking()))
+        {
+            std::vector<TravelNode*> path;
+            for (uint32 slot = currentSlot; slot != TravelNodeStub::NO_PARENT; slot = arena[slot].parent)
+                path.push_back(arena[slot].dataNode);
 
             reverse(path.begin(), path.end());
 
-            return TravelNodeRoute(path);
+            if (expansions)
+                *expansions = expanded;
+
+            return path;
         }
 
-        for (auto const& link : *currentNode->dataNode->getLinks())  // for each successor n' of n
+        for (auto const& link : *currentNode->getLinks())  // for each successor n' of n
         {
-            TravelNode* linkNode = link.first;
-            float linkCost = link.second->getCost(bot, currentNode->currentGold);
+            float linkCost = link.second->getCost(bot, currentGold);
 
             if (linkCost <= 0)
                 continue;
 
-            childNode = &m_stubs.insert(std::make_pair(linkNode, TravelNodeStub(linkNode))).first->second;
-            g = currentNode->m_g + linkCost;  // stance from start + distance between the two nodes
-            if ((childNode->open || childNode->close) &&
-                childNode->m_g <= g)  // n' is already in opend or closed with a lower cost g(n')
-                continue;             // consider next successor
+            // Slot() can grow the arena, stubs are only referenced after it
+            uint32 const childSlot = arena.Slot(link.first);
+            TravelNodeStub& childStub = arena[childSlot];
 
-            h = childNode->dataNode->fDist(goal) / botSpeed;
-            f = g + h;  // compute f(n')
-            childNode->m_f = f;
-            childNode->m_g = g;
-            childNode->m_h = h;
-            childNode->parent = currentNode;
+            float const g = currentG + linkCost;  // distance from start + distance between the two nodes
+            if ((childStub.open || childStub.close) &&
+                childStub.m_g <= g)  // n' is already in opend or closed with a lower cost g(n')
+                continue;            // consider next successor
 
-            if (bot && !bot->isTaxiCheater())
-                childNode->currentGold = currentNode->currentGold - link.second->getPrice();
+            if (childStub.m_h < 0.0f)
+                childStub.m_h = link.first->fDist(goal) / botSpeed;
 
-            if (childNode->close)
-                childNode->close = false;
+            childStub.m_g = g;
+            childStub.m_f = g + childStub.m_h;  // compute f(n')
+            childStub.parent = currentSlot;
 
-            if (!childNode->open)
-            {
-                open.push_back(childNode);
-                std::push_heap(open.begin(), open.end(),
-                               [](TravelNodeStub* i, TravelNodeStub* j) { return i->m_f < j->m_f; });
-                childNode->open = true;
-            }
+            if (bot && !bot->isTaxiCheater())
+                childStub.currentGold = currentGold - link.second->getPrice();
+
+            childStub.close = false;
+            childStub.open = true;
+            arena.Push(childSlot);
         }
     }
 
-    return TravelNodeRoute();
+    if (expansions)
+        *expansions = expanded;
+
+    return {};
 }
 
 TravelNodeRoute TravelNodeMap::getRoute(WorldPosition startPos, WorldPosition endPos,
@@ -1862,42 +2187,120 @@ void TravelNodeMap::generateNodes()
 
 void TravelNodeMap::generateWalkPaths()
 {
-    // Pathfinder
-    std::vector<WorldPosition> ppath;
+    std::vector<TravelNode*> nodes = TravelNodeMap::instance().getNodes();
 
-    std::map<uint32, bool> nodeMaps;
+    // Unlinked nodes per map, grouped in regions. Paths never cross maps, so a map is only touched by its worker.
+    std::map<uint32, std::map<std::pair<int32, int32>, std::vector<TravelNode*>>> mapRegions;
+    uint32 todo = 0;
 
-    for (auto& startNode : TravelNodeMap::instance().getNodes())
+    for (auto& startNode : nodes)
     {
-        nodeMaps[startNode->getMapId()] = true;
+        if (startNode->isLinked())
+            continue;
+
+        std::pair<int32, int32> const region = {int32(std::floor(startNode->getY() / WALK_REGION_SIZE)),
+                                                int32(std::floor(startNode->getX() / WALK_REGION_SIZE))};
+        mapRegions[startNode->getMapId()][region].push_back(startNode);
+        todo++;
     }
 
-    for (auto& map : nodeMaps)
+    if (!todo)
+        return;
+
+    // The checkpoints below address nodes by their index in the saved store
+    std::unordered_map<TravelNode*, uint32> nodeIds;
+    for (uint32 i = 0; i < nodes.size(); i++)
+        nodeIds.insert(std::make_pair(nodes[i], i));
+
+    hasToSave = true;
+    saveNodeStore(true);
+
+    struct MapJob
+    {
+        uint32 mapId;
+        std::vector<std::vector<TravelNode*>> regions;
+        uint32 nodeCount = 0;
+        std::unique_ptr<Creature> unit;
+    };
+
+    std::vector<MapJob> jobs;
+    for (auto& map : mapRegions)
     {
-        for (auto& startNode : TravelNodeMap::instance().getNodes(WorldPosition(map.first, 1, 1)))
+        MapJob job;
+        job.mapId = map.first;
+
+        for (auto& region : map.second)
         {
-            if (startNode->isLinked())
-                continue;
+            job.nodeCount += region.second.size();
+            job.regions.push_back(std::move(region.second));
+        }
+
+        // Maps are created and units spawned here, the workers only move their unit around
+        job.unit = CreatePathingUnit(map.first, *job.regions.front().front()->getPosition());
+        jobs.push_back(std::move(job));
+    }
+
+    // Biggest maps first so a continent does not start last
+    std::sort(jobs.begin(), jobs.end(), [](MapJob const& a, MapJob const& b) { return a.nodeCount > b.nodeCount; });
+
+    std::atomic<uint32> nextJob = 0;
+    std::atomic<uint32> done = 0;
+
+    auto work = [&]()
+    {
+        for (uint32 i = nextJob++; i < jobs.size(); i = nextJob++)
+        {
+            MapJob& job = jobs[i];
 
-            for (auto& endNode : TravelNodeMap::instance().getNodes(*startNode->getPosition(), 2000.0f))
+            for (auto& region : job.regions)
             {
-                if (startNode == endNode)
-                    continue;
+                std::unordered_set<TravelNode*> changed;
 
-                if (startNode->hasCompletePathTo(endNode))
-                    continue;
+                for (auto& startNode : region)
+                {
+                    for (auto& endNode : TravelNodeMap::instance().getNodes(*startNode->getPosition(), 2000.0f))
+                    {
+                        if (startNode == endNode)
+                            continue;
 
-                if (startNode->getMapId() != endNode->getMapId())
-                    continue;
+                        if (startNode->hasCompletePathTo(endNode))
+                            continue;
+
+                        if (startNode->getMapId() != endNode->getMapId())
+                            continue;
+
+                        startNode->buildPath(endNode, job.unit.get(), false);
 
-                startNode->buildPath(endNode, nullptr, false);
+                        // Reverse paths may have been added to the end node
+                        changed.insert(endNode);
+                    }
+
+                    startNode->setLinked(true);
+                    changed.insert(startNode);
+                }
+
+                CheckpointNodes(changed, nodeIds);
+                done += region.size();
             }
 
-            startNode->setLinked(true);
+            LOG_INFO("playerbots", ">> Generated paths for {} nodes of map {} ({}/{} nodes).", job.nodeCount,
+                     job.mapId, done.load(), todo);
         }
-    }
+    };
 
-    LOG_INFO("playerbots", ">> Generated paths for {} nodes.", TravelNodeMap::instance().getNodes().size());
+    uint32 workers = std::clamp<uint32>(sPlayerbotAIConfig.travelPathGenerationThreads, 1, jobs.size());
+
+    std::vector<std::future<void>> tasks;
+    for (uint32 worker = 1; worker < workers; ++worker)
+        tasks.push_back(std::async(std::launch::async, work));
+
+    work();
+
+    for (std::future<void>& task : tasks)
+        task.get();
+
+    LOG_INFO("playerbots", ">> Generated paths for {} nodes on {} maps with {} workers.", todo, jobs.size(),
+             workers);
 }
 
 void TravelNodeMap::generateTaxiPaths()
@@ -2023,6 +2426,8 @@ void TravelNodeMap::calculatePathCosts()
         }
     }
 
+    invalidateRoutes();
+
     LOG_INFO("playerbots", ">> Calculated pathcost for {} nodes.", TravelNodeMap::instance().getNodes().size());
 }
 
@@ -2081,6 +2486,131 @@ void TravelNodeMap::printMap()
     }
 }
 
+std::string const TravelNodeMap::benchmarkRoutes(uint32 count)
+{
+    std::vector<uint32> const continents = {0, 1, 530, 571};
+
+    std::shared_lock<std::shared_timed_mutex> lock(m_nMapMtx);
+
+    std::vector<std::vector<TravelNode*>> continentNodes;
+    for (uint32 mapId : continents)
+    {
+        std::vector<TravelNode*> nodes;
+        for (auto& node : m_nodes)
+        {
+            if (node->getMapId() == mapId)
+                nodes.push_back(node);
+        }
+
+        if (!nodes.empty())
+            continentNodes.push_back(nodes);
+    }
+
+    if (continentNodes.size() < 2)
+        return "Not enough continents with travel nodes to benchmark routes";
+
+    // Fixed seed, runs with the same count and nodes route the same pairs
+    std::mt19937 rng(count);
+    std::vector<uint32> times;
+    uint64 totalExpansions = 0;
+    uint32 found = 0;
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        uint32 const from = rng() % continentNodes.size();
+        uint32 const to = (from + 1 + rng() % (continentNodes.size() - 1)) % continentNodes.size();
+
+        TravelNode* start = continentNodes[from][rng() % continentNodes[from].size()];
+        TravelNode* goal = continentNodes[to][rng() % continentNodes[to].size()];
+
+        // searched directly, repeated pairs are not answered by the route cache
+        uint32 expansions = 0;
+        auto const begin = std::chrono::steady_clock::now();
+        bool const routed =
+            start->hasRouteTo(goal) && !searchRoute(start, goal, nullptr, 0, nullptr, &expansions).empty();
+        auto const end = std::chrono::steady_clock::now();
+
+        times.push_back(uint32(std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count()));
+        totalExpansions += expansions;
+        if (routed)
+            ++found;
+    }
+
+    std::sort(times.begin(), times.end());
+    uint64 totalTime = 0;
+    for (uint32 time : times)
+        totalTime += time;
+
+    std::ostringstream out;
+    out << "Routed " << count << " cross-continent node pairs over " << m_nodes.size() << " nodes, " << found
+        << " found: " << totalExpansions / count << " expansions and " << totalTime / count << " us per route (p50 "
+        << times[count / 2] << " us, p95 " << times[count * 95 / 100] << " us, max " << times.back() << " us)";
+
+    LOG_INFO("playerbots", "{}", out.str());
+    return out.str();
+}
+
+bool TravelNodeMap::HandleConsoleCommand(ChatHandler* handler, char const* args)
+{
+    std::string const command = args ? args : "";
+
+    if (command.rfind("bench", 0) == 0)
+    {
+        int32 count = command.size() > 5 ? atoi(command.c_str() + 5) : 0;
+        if (count <= 0)
+            count = 200;
+
+        handler->PSendSysMessage("{}", TravelNodeMap::instance().benchmarkRoutes(count));
+        return true;
+    }
+
+    if (command.rfind("cache", 0) == 0)
+    {
+        TravelRouteCache& cache = TravelNodeMap::instance().routeCache;
+        if (command == "cache reset")
+        {
+            cache.ResetStats();
+            handler->PSendSysMessage("Route cache statistics reset");
+            return true;
+        }
+
+        uint64 const hits = cache.GetHits();
+        uint64 const queries = hits + cache.GetMisses();
+        handler->PSendSysMessage("Route cache: {} routes, {} queries, {:.1f}% hits, {} us per query", cache.Size(),
+                                 queries, queries ? 100.0 * hits / queries : 0.0,
+                                 queries ? cache.GetQueryMicros() / queries : 0);
+        return true;
+    }
+
+    if (command == "gen")
+    {
+        // Generation takes hours and shares navmesh queries and tiles with the map threads, it only runs at
+        // startup. Unlinked nodes get their walk paths generated there, the snapshot key changes with them.
+        PlayerbotsDatabase.Execute("UPDATE playerbots_travelnode SET linked = 0");
+
+        handler->PSendSysMessage("Travel node paths will be generated on the next startup");
+        return true;
+    }
+
+    if (command.rfind("export", 0) == 0)
+    {
+        std::string fileName = command.size() > 7 ? command.substr(7) : "playerbots_travelnode_export.sql";
+
+        uint32 const count = TravelNodeMap::instance().exportNodeStore(fileName);
+        if (!count)
+        {
+            handler->PSendSysMessage("Unable to export the travel nodes to {}", fileName);
+            return false;
+        }
+
+        handler->PSendSysMessage("Exported {} travel nodes to {}", count, fileName);
+        return true;
+    }
+
+    handler->PSendSysMessage("Usage: .playerbots debug travel bench [routes] | cache [reset] | gen | export [file]");
+    return false;
+}
+
 void TravelNodeMap::printNodeStore()
 {
     std::string const nodeStore = "TravelNodeStore.h";
@@ -2169,7 +2699,7 @@ void TravelNodeMap::printNodeStore()
     fflush(stdout);
 }
 
-void TravelNodeMap::saveNodeStore()
+void TravelNodeMap::saveNodeStore(bool sync)
 {
     if (!hasToSave)
         return;
@@ -2207,63 +2737,140 @@ void TravelNodeMap::saveNodeStore()
 
     LOG_INFO("playerbots", ">> Saved {} travelNodes.", anodes.size());
 
+    uint32 paths = 0, points = 0;
+    for (uint32 i = 0; i < anodes.size(); i++)
+        AppendNodeLinks(trans, anodes[i], i, saveNodes, paths, points);
+
+    LOG_INFO("playerbots", ">> Saved {} travelNode Paths, {} points.", paths, points);
+
+    if (sync)
+        PlayerbotsDatabase.DirectCommitTransaction(trans);
+    else
+        PlayerbotsDatabase.CommitTransaction(trans);
+}
+
+uint32 TravelNodeMap::exportNodeStore(std::string const& fileName)
+{
+    std::vector<TravelNode*> anodes = getNodes();
+    if (anodes.empty())
+        return 0;
+
+    std::ofstream out(fileName, std::ios::trunc);
+    if (!out)
+        return 0;
+
+    std::unordered_map<TravelNode*, uint32> saveNodes;
+    for (uint32 i = 0; i < anodes.size(); i++)
+        saveNodes.insert(std::make_pair(anodes[i], i));
+
+    // Rows are written in batches of 1000 per insert statement
+    uint32 rows = 0;
+    auto row = [&out, &rows](std::string const& insert)
     {
-        uint32 paths = 0, points = 0;
-        for (uint32 i = 0; i < anodes.size(); i++)
+        if (rows == 1000)
         {
-            TravelNode* node = anodes[i];
+            out << ";\n\n";
+            rows = 0;
+        }
 
-            for (auto& link : *node->getLinks())
-            {
-                TravelNodePath* path = link.second;
+        out << (rows ? ",\n" : insert + "\nVALUES\n");
+        rows++;
+    };
+    auto endInsert = [&out, &rows]()
+    {
+        if (rows)
+            out << ";\n\n";
+        rows = 0;
+    };
 
-                PlayerbotsDatabasePreparedStatement* stmt =
-                    PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_INS_TRAVELNODE_LINK);
-                stmt->SetData(0, i);
-                stmt->SetData(1, saveNodes.find(link.first)->second);
-                stmt->SetData(2, static_cast<uint8>(path->getPathType()));
-                stmt->SetData(3, path->getPathObject());
-                stmt->SetData(4, path->getDistance());
-                stmt->SetData(5, path->getSwimDistance());
-                stmt->SetData(6, path->getExtraCost());
-                stmt->SetData(7, path->getCalculated());
-                stmt->SetData(8, path->getMaxLevelCreature()[0]);
-                stmt->SetData(9, path->getMaxLevelCreature()[1]);
-                stmt->SetData(10, path->getMaxLevelCreature()[2]);
-                trans->Append(stmt);
+    out << std::fixed << std::setprecision(4);
+    out << "DELETE FROM `playerbots_travelnode`;\n";
+    out << "DELETE FROM `playerbots_travelnode_link`;\n";
+    out << "DELETE FROM `playerbots_travelnode_path`;\n\n";
 
-                paths++;
+    for (uint32 i = 0; i < anodes.size(); i++)
+    {
+        TravelNode* node = anodes[i];
 
-                std::vector<WorldPosition> ppath = path->getPath();
+        std::string name = node->getName();
+        name.erase(remove(name.begin(), name.end(), '\''), name.end());
+        name.erase(remove(name.begin(), name.end(), '\\'), name.end());
 
-                for (uint32 j = 0; j < ppath.size(); j++)
-                {
-                    WorldPosition point = ppath[j];
-
-                    PlayerbotsDatabasePreparedStatement* stmt =
-                        PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_INS_TRAVELNODE_PATH);
-                    stmt->SetData(0, i);
-                    stmt->SetData(1, saveNodes.find(link.first)->second);
-                    stmt->SetData(2, j);
-                    stmt->SetData(3, point.GetMapId());
-                    stmt->SetData(4, point.GetPositionX());
-                    stmt->SetData(5, point.GetPositionY());
-                    stmt->SetData(6, point.GetPositionZ());
-                    trans->Append(stmt);
-
-                    points++;
-                }
-            }
+        row("INSERT INTO `playerbots_travelnode` (`id`, `name`, `map_id`, `x`, `y`, `z`, `linked`)");
+        out << "(" << i << ", '" << name << "', " << node->getMapId() << ", " << node->getX() << ", " << node->getY()
+            << ", " << node->getZ() << ", " << (node->isLinked() ? 1 : 0) << ")";
+    }
+    endInsert();
+
+    for (uint32 i = 0; i < anodes.size(); i++)
+    {
+        for (auto& link : *anodes[i]->getLinks())
+        {
+            TravelNodePath* path = link.second;
+
+            row("INSERT INTO `playerbots_travelnode_link` (`node_id`, `to_node_id`, `type`, `object`, `distance`, "
+                "`swim_distance`, `extra_cost`, `calculated`, `max_creature_0`, `max_creature_1`, `max_creature_2`)");
+            out << "(" << i << ", " << saveNodes.find(link.first)->second << ", "
+                << uint32(path->getPathType()) << ", " << path->getPathObject() << ", " << path->getDistance() << ", "
+                << path->getSwimDistance() << ", " << path->getExtraCost() << ", " << (path->getCalculated() ? 1 : 0)
+                << ", " << uint32(path->getMaxLevelCreature()[0]) << ", " << uint32(path->getMaxLevelCreature()[1])
+                << ", " << uint32(path->getMaxLevelCreature()[2]) << ")";
         }
+    }
+    endInsert();
 
-        LOG_INFO("playerbots", ">> Saved {} travelNode Paths, {} points.", paths, points);
+    for (uint32 i = 0; i < anodes.size(); i++)
+    {
+        for (auto& link : *anodes[i]->getLinks())
+        {
+            std::vector<WorldPosition> ppath = link.second->getPath();
+
+            for (uint32 j = 0; j < ppath.size(); j++)
+            {
+                row("INSERT INTO `playerbots_travelnode_path` (`node_id`, `to_node_id`, `nr`, `map_id`, `x`, `y`, "
+                    "`z`)");
+                out << "(" << i << ", " << saveNodes.find(link.first)->second << ", " << j << ", "
+                    << ppath[j].GetMapId() << ", " << ppath[j].GetPositionX() << ", " << ppath[j].GetPositionY()
+                    << ", " << ppath[j].GetPositionZ() << ")";
+            }
+        }
     }
+    endInsert();
 
-    PlayerbotsDatabase.CommitTransaction(trans);
+    if (!out)
+        return 0;
+
+    LOG_INFO("playerbots", ">> Exported {} travelNodes to {}.", anodes.size(), fileName);
+
+    return anodes.size();
 }
 
 void TravelNodeMap::loadNodeStore()
 {
+    uint32 oldMSTime = getMSTime();
+
+    // The snapshot is an image of the node store tables, reused as long as they do not change
+    std::string snapshotPath;
+    uint64 snapshotKey = 0;
+    if (!sPlayerbotAIConfig.travelNodeSnapshotFile.empty() && GetNodeStoreKey(snapshotKey))
+    {
+        snapshotPath = sWorld->GetDataPath() + sPlayerbotAIConfig.travelNodeSnapshotFile;
+
+        TravelNodeSnapshot snapshot;
+        if (snapshot.Read(snapshotPath, snapshotKey))
+        {
+            snapshot.Restore(*this);
+
+            if (!snapshot.IsComplete())
+                hasToGen = true;
+
+            LOG_INFO("playerbots", ">> Loaded {} travelNodes, {} paths, {} points from {} in {} ms.",
+                     snapshot.NodeCount(), snapshot.LinkCount(), snapshot.PointCount(), snapshotPath,
+                     GetMSTimeDiffToNow(oldMSTime));
+            return;
+        }
+    }
+
     std::string const query = "SELECT id, name, map_id, x, y, z, linked FROM playerbots_travelnode";
 
     std::unordered_map<uint32, TravelNode*> saveNodes;
@@ -2334,6 +2941,8 @@ void TravelNodeMap::loadNodeStore()
     }
 
     {
+        std::unordered_map<TravelNodePath*, std::vector<WorldPosition>> pathPoints;
+
         if (PreparedQueryResult result =
                 PlayerbotsDatabase.Query(PlayerbotsDatabase.GetPreparedStatement(PLAYERBOTS_SEL_TRAVELNODE_PATH)))
         {
@@ -2347,18 +2956,23 @@ void TravelNodeMap::loadNodeStore()
                 if (!startNode || !endNode || !startNode->hasPathTo(endNode))
                     continue;
 
-                TravelNodePath* path = startNode->getPathTo(endNode);
+                // Points are collected per path and set once, not copied back and forth per row
+                pathPoints[startNode->getPathTo(endNode)].push_back(WorldPosition(
+                    fields[3].Get<uint32>(), fields[4].Get<float>(), fields[5].Get<float>(), fields[6].Get<float>()));
 
-                std::vector<WorldPosition> ppath = path->getPath();
-                ppath.push_back(WorldPosition(fields[3].Get<uint32>(), fields[4].Get<float>(), fields[5].Get<float>(),
-                                              fields[6].Get<float>()));
+            } while (result->NextRow());
 
-                path->setPath(ppath);
+            for (auto& points : pathPoints)
+            {
+                TravelNodePath* path = points.first;
+
+                std::vector<WorldPosition> ppath = path->getPath();
+                ppath.insert(ppath.end(), points.second.begin(), points.second.end());
+                path->setPath(std::move(ppath));
 
                 if (path->getCalculated())
                     path->setComplete(true);
-
-            } while (result->NextRow());
+            }
 
             LOG_INFO("playerbots", ">> Loaded {} travelNode paths points.", result->GetRowCount());
         }
@@ -2367,6 +2981,15 @@ void TravelNodeMap::loadNodeStore()
             LOG_ERROR("playerbots", ">> Error loading travelNode paths.");
         }
     }
+
+    LOG_INFO("playerbots", ">> Loaded the travelNode tables in {} ms.", GetMSTimeDiffToNow(oldMSTime));
+
+    if (!snapshotPath.empty() && !hasToFullGen)
+    {
+        TravelNodeSnapshot snapshot;
+        snapshot.Capture(getNodes());
+        snapshot.Write(snapshotPath, snapshotKey);
+    }
 }
 
 void TravelNodeMap::calcMapOffset()
@@ -9,6 +9,10 @@
 #include <shared_mutex>
 
 #include "TravelMgr.h"
+#include "TravelNodeGrid.h"
+#include "TravelRouteCache.h"
+
+class ChatHandler;
 
 // THEORY
 //
@@ -121,7 +125,7 @@ public:
     // Setters
     void setComplete(bool complete1) { complete = complete1; }
 
-    void setPath(std::vector<WorldPosition> path1) { path = path1; }
+    void setPath(std::vector<WorldPosition> path1) { path = std::move(path1); }
 
     void setPathAndCost(std::vector<WorldPosition> path1, float speed)
     {
@@ -205,6 +209,7 @@ public:
     // Setters
     void setLinked(bool linked1) { linked = linked1; }
     void setPoint(WorldPosition point1) { point = point1; }
+    void setSearchIndex(uint32 index) { searchIndex = index; }
 
     // Getters
     std::string const getName() { return nodeName; };
@@ -213,6 +218,8 @@ public:
     std::unordered_map<TravelNode*, TravelNodePath*>* getLinks() { return &links; }
     bool isImportant() { return important; };
     bool isLinked() { return linked; }
+    // Index in the node list of TravelNodeMap, the slot of the node in route searches
+    uint32 getSearchIndex() { return searchIndex; }
 
     bool isTransport()
     {
@@ -261,35 +268,14 @@ public:
     float fDist(TravelNode* node) { return point.fDist(node->getPosition()); }
     float fDist(WorldPosition pos) { return point.fDist(pos); }
 
-    TravelNodePath* setPathTo(TravelNode* node, TravelNodePath path = TravelNodePath(), bool isLink = true)
-    {
-        if (this != node)
-        {
-            paths[node] = path;
-            if (isLink)
-                links[node] = &paths[node];
-
-            return &paths[node];
-        }
-
-        return nullptr;
-    }
+    TravelNodePath* setPathTo(TravelNode* node, TravelNodePath path = TravelNodePath(), bool isLink = true);
 
     bool hasPathTo(TravelNode* node) { return paths.find(node) != paths.end(); }
     TravelNodePath* getPathTo(TravelNode* node) { return &paths[node]; }
     bool hasCompletePathTo(TravelNode* node) { return hasPathTo(node) && getPathTo(node)->getComplete(); }
     TravelNodePath* buildPath(TravelNode* endNode, Unit* bot, bool postProcess = false);
 
-    void setLinkTo(TravelNode* node, float distance = 0.1f)
-    {
-        if (this != node)
-        {
-            if (!hasPathTo(node))
-                setPathTo(node, TravelNodePath(distance));
-            else
-                links[node] = &paths[node];
-        }
-    }
+    void setLinkTo(TravelNode* node, float distance = 0.1f);
 
     bool hasLinkTo(TravelNode* node) { return links.find(node) != links.end(); }
     float linkCostTo(TravelNode* node) { return paths.find(node)->second.getDistance(); }
@@ -338,6 +324,9 @@ protected:
     // This node has been checked for nearby links
     bool linked = false;
 
+    // Not in the node list until set by TravelNodeMap::addNode
+    uint32 searchIndex = 0xFFFFFFFF;
+
     // This node is a (moving) transport.
     // bool transport = false;
     // Entry of transport.
@@ -355,8 +344,9 @@ public:
         point = *baseNode->getPosition();
         paths.clear();
         links.clear();
-        TravelNodePath path(0.1f, 0.1f, (uint8)TravelNodePathType::teleportSpell, portalSpell, true);
-        setPathTo(endNode, path);
+        // Set directly, portal nodes belong to one bot and their routes are not cached
+        paths[endNode] = TravelNodePath(0.1f, 0.1f, (uint8)TravelNodePathType::teleportSpell, portalSpell, true);
+        links[endNode] = &paths[endNode];
     };
 };
 
@@ -464,13 +454,17 @@ private:
 class TravelNodeStub
 {
 public:
-    TravelNodeStub(TravelNode* dataNode1) { dataNode = dataNode1; }
+    static constexpr uint32 NO_PARENT = 0xFFFFFFFF;
+
+    TravelNodeStub(TravelNode* dataNode1 = nullptr) { dataNode = dataNode1; }
 
     TravelNode* dataNode;
-    float m_f = 0.0, m_g = 0.0, m_h = 0.0;
+    float m_f = 0.0, m_g = 0.0;
+    float m_h = -1.0;  // computed when the node is first reached
     bool open = false, close = false;
-    TravelNodeStub* parent = nullptr;
+    uint32 parent = NO_PARENT;  // search slot of the previous node
     uint32 currentGold = 0;
+    uint32 generation = 0;  // search this stub belongs to
 };
 
 // The container of all nodes.
@@ -505,7 +499,10 @@ public:
 
     // Get all nodes
     std::vector<TravelNode*> getNodes() { return m_nodes; }
+    // Nodes on the map of pos within range, nearest first
     std::vector<TravelNode*> getNodes(WorldPosition pos, float range = -1);
+    // The count nearest nodes on the map of pos within range, nearest first
+    std::vector<TravelNode*> getNearestNodes(WorldPosition pos, uint32 count, float range = -1);
 
     // Find nearest node.
     TravelNode* getNode(TravelNode* sameNode)
@@ -536,8 +533,8 @@ public:
         return rNodes[urand(0, rNodes.size() - 1)];
     }
 
-    // Finds the best nodePath between two nodes
-    TravelNodeRoute getRoute(TravelNode* start, TravelNode* goal, Player* bot = nullptr);
+    // Finds the best nodePath between two nodes, expansions receives the number of nodes expanded
+    TravelNodeRoute getRoute(TravelNode* start, TravelNode* goal, Player* bot = nullptr, uint32* expansions = nullptr);
 
     // Find the best node between two positions
     TravelNodeRoute getRoute(WorldPosition startPos, WorldPosition endPos, std::vector<WorldPosition>& startPath,
@@ -549,6 +546,9 @@ public:
     // Manage/update nodes
     void manageNodes(Unit* bot, bool mapFull = false);
 
+    // Drops the cached routes, called whenever a link or its cost changes
+    void invalidateRoutes() { routeCache.Invalidate(); }
+
     void setHasToGen() { hasToGen = true; }
 
     void generateNpcNodes();
@@ -569,8 +569,15 @@ public:
 
     void printMap();
 
+    // Routes random node pairs between the continents and reports expansions and time per route
+    std::string const benchmarkRoutes(uint32 count);
+    static bool HandleConsoleCommand(ChatHandler* handler, char const* args);
+
     void printNodeStore();
-    void saveNodeStore();
+    // Rewrites the node store tables, sync waits for the commit
+    void saveNodeStore(bool sync = false);
+    // Writes the node store as an sql file replacing the node store tables, returns the number of nodes
+    uint32 exportNodeStore(std::string const& fileName);
     void loadNodeStore();
 
     bool cropUselessNode(TravelNode* startNode);
@@ -597,6 +604,15 @@ private:
     TravelNodeMap(TravelNodeMap&&) = delete;
     TravelNodeMap& operator=(TravelNodeMap&&) = delete;
 
+    bool isListedNode(TravelNode* node)
+    {
+        return node->getSearchIndex() < m_nodes.size() && m_nodes[node->getSearchIndex()] == node;
+    }
+
+    // A* search behind getRoute
+    std::vector<TravelNode*> searchRoute(TravelNode* start, TravelNode* goal, Player* bot, uint32 startGold,
+                                         PortalNode* portNode, uint32* expansions);
+
     // Taxi graph internals
     void BuildTaxiGraph();
     void ComputeAllPaths();
@@ -608,6 +624,8 @@ private:
     std::map<uint32, std::map<uint32, std::vector<uint32>>> taxiPathCache;
 
     std::vector<TravelNode*> m_nodes;
+    TravelNodeGrid m_nodeGrid;
+    TravelRouteCache routeCache;
 
     std::vector<std::pair<uint32, WorldPosition>> mapOffsets;
 
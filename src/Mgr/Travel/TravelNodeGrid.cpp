@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#include "TravelNodeGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+void TravelNodeGrid::Insert(TravelNode* node, uint32 mapId, float x, float y, float z)
+{
+    MapGrid& grid = maps[mapId];
+    int32 const cellX = CellIndex(x);
+    int32 const cellY = CellIndex(y);
+
+    if (grid.cells.empty())
+    {
+        grid.minX = grid.maxX = cellX;
+        grid.minY = grid.maxY = cellY;
+    }
+    else
+    {
+        grid.minX = std::min(grid.minX, cellX);
+        grid.maxX = std::max(grid.maxX, cellX);
+        grid.minY = std::min(grid.minY, cellY);
+        grid.maxY = std::max(grid.maxY, cellY);
+    }
+
+    grid.cells[CellKey(cellX, cellY)].push_back({node, x, y, z});
+}
+
+void TravelNodeGrid::Remove(TravelNode* node, uint32 mapId, float x, float y)
+{
+    auto map = maps.find(mapId);
+    if (map == maps.end())
+        return;
+
+    auto cell = map->second.cells.find(CellKey(CellIndex(x), CellIndex(y)));
+    if (cell == map->second.cells.end())
+        return;
+
+    std::vector<Entry>& entries = cell->second;
+    auto entry = std::find_if(entries.begin(), entries.end(), [node](Entry const& e) { return e.node == node; });
+    if (entry == entries.end())
+        return;
+
+    *entry = entries.back();
+    entries.pop_back();
+
+    if (entries.empty())
+        map->second.cells.erase(cell);
+
+    if (map->second.cells.empty())
+        maps.erase(map);
+}
+
+std::vector<TravelNode*> TravelNodeGrid::Query(uint32 mapId, float x, float y, float z, float range,
+                                               uint32 limit) const
+{
+    std::vector<TravelNode*> nodes;
+
+    auto map = maps.find(mapId);
+    if (map == maps.end())
+        return nodes;
+
+    MapGrid const& grid = map->second;
+    Candidates candidates;
+
+    if (range >= 0.0f)
+        CollectRange(grid, x, y, z, range, candidates);
+    else if (limit)
+        CollectNearest(grid, x, y, z, limit, candidates);
+    else
+    {
+        for (auto const& cell : grid.cells)
+            Collect(cell.second, x, y, z, -1.0f, candidates);
+    }
+
+    auto nearer = [](std::pair<float, TravelNode*> const& a, std::pair<float, TravelNode*> const& b)
+    { return a.first < b.first; };
+
+    // only the nodes returned need to be ordered
+    if (limit && candidates.size() > limit)
+    {
+        std::partial_sort(candidates.begin(), candidates.begin() + limit, candidates.end(), nearer);
+        candidates.resize(limit);
+    }
+    else
+        std::sort(candidates.begin(), candidates.end(), nearer);
+
+    nodes.reserve(candidates.size());
+    for (auto const& candidate : candidates)
+        nodes.push_back(candidate.second);
+
+    return nodes;
+}
+
+int32 TravelNodeGrid::CellIndex(float coord) { return int32(std::floor(coord / CELL_SIZE)); }
+
+void TravelNodeGrid::Collect(std::vector<Entry> const& cell, float x, float y, float z, float sqRange,
+                             Candidates& candidates)
+{
+    for (Entry const& entry : cell)
+    {
+        float const dx = entry.x - x;
+        float const dy = entry.y - y;
+        float const dz = entry.z - z;
+        float const sqDist = dx * dx + dy * dy + dz * dz;
+
+        if (sqRange < 0.0f || sqDist <= sqRange)
+            candidates.emplace_back(sqDist, entry.node);
+    }
+}
+
+void TravelNodeGrid::CollectRange(MapGrid const& grid, float x, float y, float z, float range,
+                                  Candidates& candidates)
+{
+    int32 const x0 = std::max(CellIndex(x - range), grid.minX);
+    int32 const x1 = std::min(CellIndex(x + range), grid.maxX);
+    int32 const y0 = std::max(CellIndex(y - range), grid.minY);
+    int32 const y1 = std::min(CellIndex(y + range), grid.maxY);
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    float const sqRange = range * range;
+
+    // a range wider than the populated part of the map is cheaper as a scan of the existing cells
+    if (uint64(x1 - x0 + 1) * uint64(y1 - y0 + 1) > grid.cells.size())
+    {
+        for (auto const& cell : grid.cells)
+            Collect(cell.second, x, y, z, sqRange, candidates);
+
+        return;
+    }
+
+    for (int32 cellY = y0; cellY <= y1; ++cellY)
+    {
+        for (int32 cellX = x0; cellX <= x1; ++cellX)
+        {
+            auto cell = grid.cells.find(CellKey(cellX, cellY));
+            if (cell != grid.cells.end())
+                Collect(cell->second, x, y, z, sqRange, candidates);
+        }
+    }
+}
+
+void TravelNodeGrid::CollectNearest(MapGrid const& grid, float x, float y, float z, uint32 limit,
+                                    Candidates& candidates)
+{
+    int32 const centerX = CellIndex(x);
+    int32 const centerY = CellIndex(y);
+
+    auto visit = [&](int32 cellX, int32 cellY)
+    {
+        if (cellX < grid.minX || cellX > grid.maxX)
+            return;
+
+        auto cell = grid.cells.find(CellKey(cellX, cellY));
+        if (cell != grid.cells.end())
+            Collect(cell->second, x, y, z, -1.0f, candidates);
+    };
+
+    // rings of cells around the center, from the first one reaching the bounds to the one covering them
+    int32 const first = std::max({0, grid.minX - centerX, centerX - grid.maxX, grid.minY - centerY,
+                                  centerY - grid.maxY});
+    int32 const last = std::max({centerX - grid.minX, grid.maxX - centerX, centerY - grid.minY,
+                                 grid.maxY - centerY});
+
+    for (int32 ring = first; ring <= last; ++ring)
+    {
+        for (int32 cellY = std::max(centerY - ring, grid.minY); cellY <= std::min(centerY + ring, grid.maxY); ++cellY)
+        {
+            if (cellY == centerY - ring || cellY == centerY + ring)
+            {
+                int32 const endX = std::min(centerX + ring, grid.maxX);
+                for (int32 cellX = std::max(centerX - ring, grid.minX); cellX <= endX; ++cellX)
+                    visit(cellX, cellY);
+            }
+            else
+            {
+                visit(centerX - ring, cellY);
+                visit(centerX + ring, cellY);
+            }
+        }
+
+        if (candidates.size() < limit)
+            continue;
+
+        // cells beyond this ring are at least ring * CELL_SIZE away from the position
+        std::nth_element(candidates.begin(), candidates.begin() + (limit - 1), candidates.end(),
+                         [](std::pair<float, TravelNode*> const& a, std::pair<float, TravelNode*> const& b)
+                         { return a.first < b.first; });
+
+        float const reach = ring * CELL_SIZE;
+        if (candidates[limit - 1].first <= reach * reach)
+            return;
+    }
+}
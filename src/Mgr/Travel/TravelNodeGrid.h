@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#ifndef _PLAYERBOT_TRAVELNODEGRID_H
+#define _PLAYERBOT_TRAVELNODEGRID_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Define.h"
+
+class TravelNode;
+
+/**
+ * @brief Spatial index of the travel nodes, a uniform grid of square cells per map
+ *
+ * Cells are keyed by their (x, y) index, so only cells holding nodes exist. Each cell keeps the node
+ * positions next to the node pointers, queries never touch the nodes themselves.
+ *
+ * Radius queries visit the cells overlapping the range. Nearest-node queries without a range visit
+ * rings of cells around the position and stop once no unvisited cell can hold a closer node.
+ * Distances are 3D like TravelNode::getDistance, the cells only cover x and y.
+ *
+ * The grid is not locked, it is updated together with TravelNodeMap::m_nodes under m_nMapMtx.
+ */
+class TravelNodeGrid
+{
+public:
+    void Insert(TravelNode* node, uint32 mapId, float x, float y, float z);
+    void Remove(TravelNode* node, uint32 mapId, float x, float y);
+    void Clear() { maps.clear(); }
+
+    /**
+     * @brief Nodes of the map within range of the position, nearest first
+     * @param range max distance, negative for the whole map
+     * @param limit max number of nodes returned, 0 for all
+     */
+    std::vector<TravelNode*> Query(uint32 mapId, float x, float y, float z, float range, uint32 limit = 0) const;
+
+private:
+    static constexpr float CELL_SIZE = 250.0f;
+
+    struct Entry
+    {
+        TravelNode* node;
+        float x;
+        float y;
+        float z;
+    };
+
+    struct MapGrid
+    {
+        std::unordered_map<uint64, std::vector<Entry>> cells;
+        // cell index bounds of all nodes ever inserted, only grows
+        int32 minX = 0;
+        int32 maxX = 0;
+        int32 minY = 0;
+        int32 maxY = 0;
+    };
+
+    typedef std::vector<std::pair<float, TravelNode*>> Candidates;
+
+    static int32 CellIndex(float coord);
+    static uint64 CellKey(int32 cellX, int32 cellY) { return (uint64(uint32(cellX)) << 32) | uint32(cellY); }
+
+    static void Collect(std::vector<Entry> const& cell, float x, float y, float z, float sqRange,
+                        Candidates& candidates);
+    static void CollectRange(MapGrid const& grid, float x, float y, float z, float range, Candidates& candidates);
+    static void CollectNearest(MapGrid const& grid, float x, float y, float z, uint32 limit, Candidates& candidates);
+
+    std::unordered_map<uint32, MapGrid> maps;
+};
+
+#endif
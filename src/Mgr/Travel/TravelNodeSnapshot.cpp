@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#include "TravelNodeSnapshot.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Log.h"
+#include "TravelNode.h"
+
+namespace
+{
+    constexpr uint32 SNAPSHOT_MAGIC = 0x4E544250;  // "PBTN"
+    constexpr uint32 SNAPSHOT_VERSION = 1;
+
+    static_assert(sizeof(TravelNodeSnapshot::Node) == 20);
+    static_assert(sizeof(TravelNodeSnapshot::Link) == 28);
+    static_assert(sizeof(TravelNodeSnapshot::Point) == 16);
+
+    template <class T>
+    void PutArray(std::ofstream& file, std::vector<T> const& array)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        uint32 const count = array.size();
+        file.write(reinterpret_cast<char const*>(&count), sizeof(count));
+        file.write(reinterpret_cast<char const*>(array.data()), array.size() * sizeof(T));
+    }
+
+    class SnapshotReader
+    {
+    public:
+        SnapshotReader(std::vector<char> const& data) : pos(data.data()), end(data.data() + data.size()) {}
+
+        template <class T>
+        bool Get(T& value)
+        {
+            if (size_t(end - pos) < sizeof(value))
+                return false;
+
+            memcpy(&value, pos, sizeof(value));
+            pos += sizeof(value);
+            return true;
+        }
+
+        template <class T>
+        bool GetArray(std::vector<T>& array)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            uint32 count = 0;
+            if (!Get(count) || size_t(end - pos) / sizeof(T) < count)
+                return false;
+
+            array.resize(count);
+            if (count)
+                memcpy(array.data(), pos, count * sizeof(T));
+
+            pos += count * sizeof(T);
+            return true;
+        }
+
+        bool AtEnd() const { return pos == end; }
+
+    private:
+        char const* pos;
+        char const* end;
+    };
+
+    // Offsets of rows stored back to back, count + 1 non decreasing entries from 0 to size
+    bool IsValidOffsets(std::vector<uint32> const& offsets, size_t count, size_t size)
+    {
+        if (offsets.size() != count + 1 || offsets.front() != 0 || offsets.back() != size)
+            return false;
+
+        for (size_t i = 1; i < offsets.size(); ++i)
+        {
+            if (offsets[i] < offsets[i - 1])
+                return false;
+        }
+
+        return true;
+    }
+}
+
+void TravelNodeSnapshot::Capture(std::vector<TravelNode*> const& nodeList)
+{
+    Clear();
+
+    std::unordered_map<TravelNode*, uint32> indexes;
+    for (uint32 i = 0; i < nodeList.size(); ++i)
+        indexes.emplace(nodeList[i], i);
+
+    nodes.reserve(nodeList.size());
+    nameOffsets.reserve(nodeList.size() + 1);
+    linkOffsets.reserve(nodeList.size() + 1);
+
+    nameOffsets.push_back(0);
+    linkOffsets.push_back(0);
+    pointOffsets.push_back(0);
+
+    for (TravelNode* node : nodeList)
+    {
+        nodes.push_back({node->getMapId(), node->getX(), node->getY(), node->getZ(), node->isLinked() ? 1u : 0u});
+
+        std::string const name = node->getName();
+        names.insert(names.end(), name.begin(), name.end());
+        nameOffsets.push_back(names.size());
+
+        for (auto& entry : *node->getLinks())
+        {
+            auto index = indexes.find(entry.first);
+            if (index == indexes.end())
+                continue;
+
+            TravelNodePath* path = entry.second;
+            std::vector<uint8> const maxLevelCreature = path->getMaxLevelCreature();
+
+            Link link = {};
+            link.toNode = index->second;
+            link.object = path->getPathObject();
+            link.distance = path->getDistance();
+            link.swimDistance = path->getSwimDistance();
+            link.extraCost = path->getExtraCost();
+            link.type = uint8(path->getPathType());
+            link.calculated = path->getCalculated();
+            for (uint32 i = 0; i < 3 && i < maxLevelCreature.size(); ++i)
+                link.maxLevelCreature[i] = maxLevelCreature[i];
+
+            links.push_back(link);
+
+            for (WorldPosition const& point : path->getPath())
+                points.push_back({point.GetMapId(), point.GetPositionX(), point.GetPositionY(), point.GetPositionZ()});
+
+            pointOffsets.push_back(points.size());
+        }
+
+        linkOffsets.push_back(links.size());
+    }
+}
+
+std::vector<TravelNode*> TravelNodeSnapshot::Restore(TravelNodeMap& nodeMap) const
+{
+    std::vector<TravelNode*> created;
+    created.reserve(nodes.size());
+
+    // The image was taken from a node map, its nodes are known to be distinct
+    for (uint32 i = 0; i < nodes.size(); ++i)
+    {
+        Node const& node = nodes[i];
+        std::string const name(names.data() + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+
+        TravelNode* travelNode = nodeMap.addNode(WorldPosition(node.mapId, node.x, node.y, node.z), name, true, false);
+        if (node.linked)
+            travelNode->setLinked(true);
+
+        created.push_back(travelNode);
+    }
+
+    for (uint32 i = 0; i < nodes.size(); ++i)
+    {
+        for (uint32 j = linkOffsets[i]; j < linkOffsets[i + 1]; ++j)
+        {
+            Link const& link = links[j];
+
+            TravelNodePath* path = created[i]->setPathTo(
+                created[link.toNode],
+                TravelNodePath(link.distance, link.extraCost, link.type, link.object, link.calculated,
+                               {link.maxLevelCreature[0], link.maxLevelCreature[1], link.maxLevelCreature[2]},
+                               link.swimDistance),
+                true);
+
+            if (pointOffsets[j] == pointOffsets[j + 1])
+                continue;
+
+            std::vector<WorldPosition> pathPoints;
+            pathPoints.reserve(pointOffsets[j + 1] - pointOffsets[j]);
+            for (uint32 k = pointOffsets[j]; k < pointOffsets[j + 1]; ++k)
+                pathPoints.emplace_back(points[k].mapId, points[k].x, points[k].y, points[k].z);
+
+            path->setPath(std::move(pathPoints));
+
+            // as loaded from the path table
+            if (link.calculated)
+                path->setComplete(true);
+        }
+    }
+
+    return created;
+}
+
+bool TravelNodeSnapshot::Read(std::string const& path, uint64 key)
+{
+    Clear();
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    std::streamoff size = file.tellg();
+    if (size <= 0)
+        return false;
+
+    std::vector<char> data(size);
+    file.seekg(0);
+    if (!file.read(data.data(), data.size()))
+        return false;
+
+    SnapshotReader reader(data);
+
+    uint32 magic = 0;
+    uint32 version = 0;
+    uint64 fileKey = 0;
+    if (!reader.Get(magic) || !reader.Get(version) || !reader.Get(fileKey) || magic != SNAPSHOT_MAGIC ||
+        version != SNAPSHOT_VERSION || fileKey != key)
+    {
+        LOG_INFO("server.loading", "Travel node snapshot {} is outdated, loading the travel node tables", path);
+        return false;
+    }
+
+    if (!reader.GetArray(nodes) || !reader.GetArray(nameOffsets) || !reader.GetArray(names) ||
+        !reader.GetArray(linkOffsets) || !reader.GetArray(links) || !reader.GetArray(pointOffsets) ||
+        !reader.GetArray(points) || !reader.AtEnd() || !IsValid())
+    {
+        LOG_ERROR("playerbots", "Travel node snapshot {} is damaged, loading the travel node tables", path);
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool TravelNodeSnapshot::Write(std::string const& path, uint64 key) const
+{
+    // Written aside and renamed, an interrupted write never leaves a truncated snapshot
+    std::string const temp = path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            LOG_ERROR("playerbots", "Can't write travel node snapshot {}", temp);
+            return false;
+        }
+
+        file.write(reinterpret_cast<char const*>(&SNAPSHOT_MAGIC), sizeof(SNAPSHOT_MAGIC));
+        file.write(reinterpret_cast<char const*>(&SNAPSHOT_VERSION), sizeof(SNAPSHOT_VERSION));
+        file.write(reinterpret_cast<char const*>(&key), sizeof(key));
+
+        PutArray(file, nodes);
+        PutArray(file, nameOffsets);
+        PutArray(file, names);
+        PutArray(file, linkOffsets);
+        PutArray(file, links);
+        PutArray(file, pointOffsets);
+        PutArray(file, points);
+
+        if (!file)
+        {
+            LOG_ERROR("playerbots", "Can't write travel node snapshot {}", temp);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error)
+    {
+        LOG_ERROR("playerbots", "Can't replace travel node snapshot {}: {}", path, error.message());
+        return false;
+    }
+
+    LOG_INFO("server.loading", "Travel node snapshot saved to {} ({} KB)", path,
+             std::filesystem::file_size(path, error) / 1024);
+    return true;
+}
+
+bool TravelNodeSnapshot::IsComplete() const
+{
+    for (Node const& node : nodes)
+    {
+        if (!node.linked)
+            return false;
+    }
+
+    for (Link const& link : links)
+    {
+        if (!link.calculated)
+            return false;
+    }
+
+    return true;
+}
+
+void TravelNodeSnapshot::Clear()
+{
+    nodes.clear();
+    nameOffsets.clear();
+    names.clear();
+    linkOffsets.clear();
+    links.clear();
+    pointOffsets.clear();
+    points.clear();
+}
+
+bool TravelNodeSnapshot::IsValid() const
+{
+    if (!IsValidOffsets(nameOffsets, nodes.size(), names.size()) ||
+        !IsValidOffsets(linkOffsets, nodes.size(), links.size()) ||
+        !IsValidOffsets(pointOffsets, links.size(), points.size()))
+        return false;
+
+    for (Link const& link : links)
+    {
+        if (link.toNode >= nodes.size())
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#ifndef _PLAYERBOT_TRAVELNODESNAPSHOT_H
+#define _PLAYERBOT_TRAVELNODESNAPSHOT_H
+
+#include <string>
+#include <vector>
+
+#include "Define.h"
+
+class TravelNode;
+class TravelNodeMap;
+
+/**
+ * @brief Binary image of the travel node store, loaded at startup instead of the node store tables
+ *
+ * Nodes are stored by index. The links of node i are links[linkOffsets[i], linkOffsets[i + 1]) (compressed
+ * sparse rows) and the path points of link j are points[pointOffsets[j], pointOffsets[j + 1]). Names are
+ * stored back to back the same way. Every array is written and read as one block.
+ *
+ * The tables stay the import and export format of the store, the image is rebuilt from them when they change.
+ */
+class TravelNodeSnapshot
+{
+public:
+    struct Node
+    {
+        uint32 mapId;
+        float x;
+        float y;
+        float z;
+        uint32 linked;
+    };
+
+    struct Link
+    {
+        uint32 toNode;
+        uint32 object;
+        float distance;
+        float swimDistance;
+        float extraCost;
+        uint8 type;
+        uint8 calculated;
+        uint8 maxLevelCreature[3];
+        uint8 padding[3];
+    };
+
+    struct Point
+    {
+        uint32 mapId;
+        float x;
+        float y;
+        float z;
+    };
+
+    /**
+     * @brief Replaces the content with the nodes and their links and paths, links leaving the list are dropped
+     */
+    void Capture(std::vector<TravelNode*> const& nodeList);
+
+    /**
+     * @brief Adds the nodes, links and paths to the node map
+     * @return the nodes created, by index
+     */
+    std::vector<TravelNode*> Restore(TravelNodeMap& nodeMap) const;
+
+    /**
+     * @brief Reads an image written with the same key
+     * @return false, leaving the image empty, if the file is missing, outdated or damaged
+     */
+    bool Read(std::string const& path, uint64 key);
+    bool Write(std::string const& path, uint64 key) const;
+
+    // Whether all nodes are linked and all links calculated, else the paths have to be generated
+    bool IsComplete() const;
+
+    uint32 NodeCount() const { return nodes.size(); }
+    uint32 LinkCount() const { return links.size(); }
+    uint32 PointCount() const { return points.size(); }
+
+private:
+    void Clear();
+    bool IsValid() const;
+
+    std::vector<Node> nodes;
+    std::vector<uint32> nameOffsets;
+    std::vector<char> names;
+    std::vector<uint32> linkOffsets;
+    std::vector<Link> links;
+    std::vector<uint32> pointOffsets;
+    std::vector<Point> points;
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#include "TravelRouteCache.h"
+
+#include <functional>
+
+size_t TravelRouteCache::KeyHash::operator()(Key const& key) const
+{
+    size_t hash = std::hash<TravelNode*>()(key.start);
+    hash ^= std::hash<TravelNode*>()(key.goal) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint32>()(key.profile) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+bool TravelRouteCache::Get(Key const& key, std::vector<TravelNode*>& route)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto found = index.find(key);
+    if (found == index.end())
+        return false;
+
+    if (found->second->generation != generation)
+    {
+        entries.erase(found->second);
+        index.erase(found);
+        return false;
+    }
+
+    entries.splice(entries.begin(), entries, found->second);
+    route = found->second->route;
+    return true;
+}
+
+void TravelRouteCache::Put(Key const& key, std::vector<TravelNode*> const& route, uint32 capacity,
+                           uint32 generation)
+{
+    if (!capacity)
+        return;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (generation != this->generation)
+        return;
+
+    auto found = index.find(key);
+    if (found != index.end())
+    {
+        found->second->route = route;
+        found->second->generation = generation;
+        entries.splice(entries.begin(), entries, found->second);
+        return;
+    }
+
+    entries.push_front({key, route, generation});
+    index.emplace(key, entries.begin());
+
+    while (entries.size() > capacity)
+    {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+void TravelRouteCache::Remove(Key const& key)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto found = index.find(key);
+    if (found == index.end())
+        return;
+
+    entries.erase(found->second);
+    index.erase(found);
+}
+
+void TravelRouteCache::Clear()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    entries.clear();
+    index.clear();
+}
+
+void TravelRouteCache::AddQuery(bool hit, uint64 micros)
+{
+    ++(hit ? hits : misses);
+    queryMicros += micros;
+}
+
+uint32 TravelRouteCache::Size()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return entries.size();
+}
+
+void TravelRouteCache::ResetStats()
+{
+    hits = 0;
+    misses = 0;
+    queryMicros = 0;
+}
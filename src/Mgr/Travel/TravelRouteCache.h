@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#ifndef _PLAYERBOT_TRAVELROUTECACHE_H
+#define _PLAYERBOT_TRAVELROUTECACHE_H
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Define.h"
+
+class TravelNode;
+
+/**
+ * @brief Least recently used cache of node routes found by TravelNodeMap::getRoute
+ *
+ * Routes are keyed by start node, goal node and a profile of the bot attributes changing link costs,
+ * so bots with the same profile share routes. The cache is shared by the map update threads and locked
+ * internally. It holds node pointers and has to be cleared when nodes are added or removed. Link changes
+ * invalidate it, routes of an older generation are dropped on lookup.
+ */
+class TravelRouteCache
+{
+public:
+    struct Key
+    {
+        TravelNode* start;
+        TravelNode* goal;
+        uint32 profile;
+
+        bool operator==(Key const& other) const
+        {
+            return start == other.start && goal == other.goal && profile == other.profile;
+        }
+    };
+
+    /**
+     * @brief Copies the cached route of key into route and marks it recently used
+     */
+    bool Get(Key const& key, std::vector<TravelNode*>& route);
+
+    /**
+     * @brief Adds or replaces the route of key, dropping the least recently used routes beyond capacity
+     * @param generation GetGeneration() from before the route search, a route found on older links is not stored
+     */
+    void Put(Key const& key, std::vector<TravelNode*> const& route, uint32 capacity, uint32 generation);
+
+    void Remove(Key const& key);
+    void Clear();
+
+    // Called on every link change, cheap enough for the node generation loops
+    void Invalidate() { ++generation; }
+    uint32 GetGeneration() const { return generation; }
+
+    /**
+     * @brief Counts a route query answered from the cache or by a search, and its duration
+     */
+    void AddQuery(bool hit, uint64 micros);
+
+    uint32 Size();
+    uint64 GetHits() const { return hits; }
+    uint64 GetMisses() const { return misses; }
+    uint64 GetQueryMicros() const { return queryMicros; }
+    void ResetStats();
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(Key const& key) const;
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::vector<TravelNode*> route;
+        uint32 generation;
+    };
+
+    std::mutex lock;
+    std::list<Entry> entries;  // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+    std::atomic<uint32> generation{0};
+    std::atomic<uint64> hits{0};
+    std::atomic<uint64> misses{0};
+    std::atomic<uint64> queryMicros{0};
+};
+
+#endif
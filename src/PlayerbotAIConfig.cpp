@@ -200,6 +200,12 @@ bool PlayerbotAIConfig::Initialize()
         sConfigMgr->GetOption<int32>("AiPlayerbot.RandomBotCountChangeMinInterval", 30 * MINUTE);
     randomBotCountChangeMaxInterval =
         sConfigMgr->GetOption<int32>("AiPlayerbot.RandomBotCountChangeMaxInterval", 2 * HOUR);
+    randomBotEventFlushInterval = sConfigMgr->GetOption<int32>("AiPlayerbot.RandomBotEventFlushInterval", 5);
+    randomBotEventFlushMaxRows = sConfigMgr->GetOption<int32>("AiPlayerbot.RandomBotEventFlushMaxRows", 1000);
+    itemCacheSnapshotFile =
+        sConfigMgr->GetOption<std::string>("AiPlayerbot.ItemCacheSnapshotFile", "playerbots_item_cache.bin");
+    travelNodeSnapshotFile =
+        sConfigMgr->GetOption<std::string>("AiPlayerbot.TravelNodeSnapshotFile", "playerbots_travelnodes.bin");
     minRandomBotInWorldTime = sConfigMgr->GetOption<int32>("AiPlayerbot.MinRandomBotInWorldTime", 2 * HOUR);
     maxRandomBotInWorldTime = sConfigMgr->GetOption<int32>("AiPlayerbot.MaxRandomBotInWorldTime", 14 * 24 * HOUR);
     minRandomBotRandomizeTime = sConfigMgr->GetOption<int32>("AiPlayerbot.MinRandomBotRandomizeTime", 2 * HOUR);
@@ -430,6 +436,8 @@ bool PlayerbotAIConfig::Initialize()
     botTaxiDelayMax = sConfigMgr->GetOption<uint32>("AiPlayerbot.BotTaxiDelayMaxMs", 5000);
     botTaxiGapMs = sConfigMgr->GetOption<uint32>("AiPlayerbot.BotTaxiGapMs", 200);
     botTaxiGapJitterMs = sConfigMgr->GetOption<uint32>("AiPlayerbot.BotTaxiGapJitterMs", 100);
+    travelRouteCacheSize = sConfigMgr->GetOption<uint32>("AiPlayerbot.TravelRouteCacheSize", 4096);
+    travelPathGenerationThreads = sConfigMgr->GetOption<uint32>("AiPlayerbot.TravelPathGenerationThreads", 4);
 
     LOG_INFO("server.loading", "Loading TalentSpecs...");
 
@@ -517,6 +525,12 @@ bool PlayerbotAIConfig::Initialize()
 
     LoadListString<std::vector<std::string>>(sConfigMgr->GetOption<std::string>("AiPlayerbot.AllowedLogFiles", ""),
                                              allowedLogFiles);
+
+    tickCachedValues.clear();
+    LoadListString<std::vector<std::string>>(sConfigMgr->GetOption<std::string>("AiPlayerbot.TickCachedValues", ""),
+                                             tickCachedValues);
+    ++tickCachedValuesVersion;
+
     LoadListString<std::vector<std::string>>(sConfigMgr->GetOption<std::string>("AiPlayerbot.TradeActionExcludedPrefixes", ""),
                                              tradeActionExcludedPrefixes);
 
@@ -610,6 +624,9 @@ bool PlayerbotAIConfig::Initialize()
     botActiveAloneSmartScale = sConfigMgr->GetOption<bool>("AiPlayerbot.botActiveAloneSmartScale", 1);
     botActiveAloneSmartScaleDiffLimitfloor = sConfigMgr->GetOption<uint32>("AiPlayerbot.botActiveAloneSmartScaleDiffLimitfloor", 50);
     botActiveAloneSmartScaleDiffLimitCeiling = sConfigMgr->GetOption<uint32>("AiPlayerbot.botActiveAloneSmartScaleDiffLimitCeiling", 200);
+    botActiveAloneSmartScaleKp = sConfigMgr->GetOption<float>("AiPlayerbot.botActiveAloneSmartScaleKp", 0.002f);
+    botActiveAloneSmartScaleKi = sConfigMgr->GetOption<float>("AiPlayerbot.botActiveAloneSmartScaleKi", 0.0f);
+    botActiveAloneSmartScaleKd = sConfigMgr->GetOption<float>("AiPlayerbot.botActiveAloneSmartScaleKd", 0.001f);
     botActiveAloneSmartScaleWhenMinLevel = sConfigMgr->GetOption<uint32>("AiPlayerbot.botActiveAloneSmartScaleWhenMinLevel", 1);
     botActiveAloneSmartScaleWhenMaxLevel = sConfigMgr->GetOption<uint32>("AiPlayerbot.botActiveAloneSmartScaleWhenMaxLevel", 80);
 
@@ -635,6 +652,7 @@ bool PlayerbotAIConfig::Initialize()
     autoEquipUpgradeLoot = sConfigMgr->GetOption<bool>("AiPlayerbot.AutoEquipUpgradeLoot", true);
     equipUpgradeThreshold = sConfigMgr->GetOption<float>("AiPlayerbot.EquipUpgradeThreshold", 1.1f);
     twoRoundsGearInit = sConfigMgr->GetOption<bool>("AiPlayerbot.TwoRoundsGearInit", false);
+    gearInitThreads = sConfigMgr->GetOption<uint32>("AiPlayerbot.GearInitThreads", 4);
     syncQuestWithPlayer = sConfigMgr->GetOption<bool>("AiPlayerbot.SyncQuestWithPlayer", true);
     syncQuestForPlayer = sConfigMgr->GetOption<bool>("AiPlayerbot.SyncQuestForPlayer", false);
     dropObsoleteQuests = sConfigMgr->GetOption<bool>("AiPlayerbot.DropObsoleteQuests", true);
@@ -736,6 +754,11 @@ bool PlayerbotAIConfig::IsInPvpProhibitedArea(uint32 id)
     return find(pvpProhibitedAreaIds.begin(), pvpProhibitedAreaIds.end(), id) != pvpProhibitedAreaIds.end();
 }
 
+bool PlayerbotAIConfig::IsTickCachedValue(std::string const& name) const
+{
+    return std::find(tickCachedValues.begin(), tickCachedValues.end(), name) != tickCachedValues.end();
+}
+
 bool PlayerbotAIConfig::IsRestrictedHealerDPSMap(uint32 mapId) const
 {
     return restrictHealerDPS &&
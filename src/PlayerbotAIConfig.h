@@ -132,6 +132,9 @@ public:
     float randomBotRpgChance;
     uint32 minRandomBots, maxRandomBots;
     uint32 randomBotUpdateInterval, randomBotCountChangeMinInterval, randomBotCountChangeMaxInterval;
+    uint32 randomBotEventFlushInterval, randomBotEventFlushMaxRows;
+    std::string itemCacheSnapshotFile;
+    std::string travelNodeSnapshotFile;
     uint32 minRandomBotInWorldTime, maxRandomBotInWorldTime;
     uint32 minRandomBotRandomizeTime, maxRandomBotRandomizeTime;
     uint32 minRandomBotChangeStrategyTime, maxRandomBotChangeStrategyTime;
@@ -311,6 +314,10 @@ public:
     std::vector<std::string> botCheats;
     uint32 botCheatMask = 0;
 
+    std::vector<std::string> tickCachedValues;
+    uint32 tickCachedValuesVersion = 0;  // bumped on every config load, values resolve their flag again
+    bool IsTickCachedValue(std::string const& name) const;
+
     struct worldBuff
     {
         uint32 spellId;
@@ -345,6 +352,7 @@ public:
     bool botActiveAloneSmartScale;
     uint32 botActiveAloneSmartScaleDiffLimitfloor;
     uint32 botActiveAloneSmartScaleDiffLimitCeiling;
+    float botActiveAloneSmartScaleKp, botActiveAloneSmartScaleKi, botActiveAloneSmartScaleKd;
     uint32 botActiveAloneSmartScaleWhenMinLevel;
     uint32 botActiveAloneSmartScaleWhenMaxLevel;
 
@@ -357,6 +365,7 @@ public:
     bool autoEquipUpgradeLoot;
     float equipUpgradeThreshold;
     bool twoRoundsGearInit;
+    uint32 gearInitThreads;
     bool syncQuestWithPlayer;
     bool syncQuestForPlayer;
     bool dropObsoleteQuests;
@@ -435,6 +444,8 @@ public:
     uint32 botTaxiDelayMax;
     uint32 botTaxiGapMs;
     uint32 botTaxiGapJitterMs;
+    uint32 travelRouteCacheSize;
+    uint32 travelPathGenerationThreads;
 
     std::string const GetTimestampStr();
     bool hasLog(std::string const fileName)
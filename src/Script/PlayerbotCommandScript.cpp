@@ -20,6 +20,7 @@
 #include "PlayerbotMgr.h"
 #include "RandomPlayerbotMgr.h"
 #include "ScriptMgr.h"
+#include "TravelNode.h"
 
 using namespace Acore::ChatCommands;
 
@@ -32,6 +33,7 @@ public:
     {
         static ChatCommandTable playerbotsDebugCommandTable = {
             {"bg", HandleDebugBGCommand, SEC_GAMEMASTER, Console::Yes},
+            {"travel", HandleDebugTravelCommand, SEC_GAMEMASTER, Console::Yes},
         };
 
         static ChatCommandTable playerbotsAccountCommandTable = {
@@ -92,6 +94,12 @@ public:
             return true;
         }
 
+        if (!strcmp(args, "cache"))
+        {
+            sPerfMonitor.PrintCacheStats();
+            return true;
+        }
+
         if (!strcmp(args, "toggle"))
         {
             sPlayerbotAIConfig.perfMonEnabled = !sPlayerbotAIConfig.perfMonEnabled;
@@ -111,6 +119,11 @@ public:
         return BGTactics::HandleConsoleCommand(handler, args);
     }
 
+    static bool HandleDebugTravelCommand(ChatHandler* handler, char const* args)
+    {
+        return TravelNodeMap::HandleConsoleCommand(handler, args);
+    }
+
     static bool HandleSetSecurityKeyCommand(ChatHandler* handler, char const* args)
     {
         if (!args || !*args)
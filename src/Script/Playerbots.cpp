@@ -89,7 +89,9 @@ public:
         PLAYERHOOK_CAN_PLAYER_USE_GUILD_CHAT,
         PLAYERHOOK_CAN_PLAYER_USE_CHANNEL_CHAT,
         PLAYERHOOK_ON_GIVE_EXP,
-        PLAYERHOOK_ON_BEFORE_TELEPORT
+        PLAYERHOOK_ON_BEFORE_TELEPORT,
+        PLAYERHOOK_ON_LEARN_SPELL,
+        PLAYERHOOK_ON_FORGOT_SPELL
     }) {}
 
     void OnPlayerLogin(Player* player) override
@@ -275,6 +277,18 @@ public:
         return true;
     }
 
+    void OnPlayerLearnSpell(Player* player, uint32 /*spellID*/) override
+    {
+        if (PlayerbotAI* botAI = GET_PLAYERBOT_AI(player))
+            botAI->OnSpellbookChanged();
+    }
+
+    void OnPlayerForgotSpell(Player* player, uint32 /*spellID*/) override
+    {
+        if (PlayerbotAI* botAI = GET_PLAYERBOT_AI(player))
+            botAI->OnSpellbookChanged();
+    }
+
     void OnPlayerGiveXP(Player* player, uint32& amount, Unit* /*victim*/, uint8 /*xpSource*/) override
     {
         // early return
@@ -379,6 +393,8 @@ public:
     void OnUpdate(uint32 diff) override
     {
         PlayerbotWorldThreadProcessor::instance().Update(diff);
+        sRandomPlayerbotMgr.UpdatePresenceIndex(diff);
+        sRandomPlayerbotMgr.UpdateActivityGovernor(diff);
         sRandomPlayerbotMgr.UpdateAI(diff);  // World thread only
     }
 };
@@ -476,6 +492,8 @@ public:
     {
         LOG_INFO("playerbots", "Logging out all bots...");
         sRandomPlayerbotMgr.LogoutAllBots();
+        // the server stops next, the rows must be in the table before the database goes away
+        sRandomPlayerbotMgr.FlushEventValues(true);
     }
 };
 
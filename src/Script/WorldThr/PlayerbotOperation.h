@@ -77,6 +77,17 @@ public:
      * @return true if operation should be executed, false to skip
      */
     virtual bool IsValid() const { return true; }
+
+    /**
+     * @brief Check if a newer operation of the same type for the same bot supersedes this one
+     *
+     * When true, queuing this operation while one of the same type for the same GetBotGuid() is still
+     * pending replaces the pending one instead of adding a second. Only opt in when the operation depends
+     * on nothing but the bot, or when its latest parameters make earlier ones redundant.
+     *
+     * @return true to allow coalescing
+     */
+    virtual bool CanCoalesce() const { return false; }
 };
 
 /**
@@ -201,6 +201,8 @@ public:
 
     std::string GetName() const override { return "GroupConvertToRaid"; }
 
+    bool CanCoalesce() const override { return true; }
+
     bool IsValid() const override
     {
         Player* bot = ObjectAccessor::FindPlayer(m_botGuid);
@@ -437,6 +439,7 @@ public:
     ObjectGuid GetBotGuid() const override { return m_botGuid; }
     uint32 GetPriority() const override { return 70; }
     std::string GetName() const override { return "BotLogoutGroupCleanup"; }
+    bool CanCoalesce() const override { return true; }
 
     bool IsValid() const override
     {
@@ -4,6 +4,7 @@
  */
 
 #include <algorithm>
+#include <typeinfo>
 
 #include "PlayerbotWorldThreadProcessor.h"
 
@@ -39,117 +40,209 @@ bool PlayerbotWorldThreadProcessor::QueueOperation(std::unique_ptr<PlayerbotOper
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-
-    // Check if queue is full
-    if (m_operationQueue.size() >= m_maxQueueSize)
+    // Reserve a slot, so the queue size check needs no lock
+    uint32 queueSize = m_queueSize.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (queueSize > m_maxQueueSize)
     {
+        m_queueSize.fetch_sub(1, std::memory_order_relaxed);
+
         LOG_ERROR("playerbots",
                   "PlayerbotWorldThreadProcessor queue is full ({} operations). Dropping operation: {}",
                   m_maxQueueSize, operation->GetName());
 
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.totalOperationsSkipped++;
+        m_droppedOperations.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
 
-    // Queue the operation
-    m_operationQueue.push(std::move(operation));
+    uint32 maxSeen = m_maxQueueSizeSeen.load(std::memory_order_relaxed);
+    while (queueSize > maxSeen &&
+           !m_maxQueueSizeSeen.compare_exchange_weak(maxSeen, queueSize, std::memory_order_relaxed))
+    {
+    }
 
-    // Update statistics
+    // Queue the operation
+    IngressNode* node = new IngressNode{std::move(operation), m_ingress.load(std::memory_order_relaxed)};
+    while (!m_ingress.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
     {
-        std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.currentQueueSize = static_cast<uint32>(m_operationQueue.size());
-        m_stats.maxQueueSize = std::max(m_stats.maxQueueSize, m_stats.currentQueueSize);
     }
 
     return true;
 }
 
-void PlayerbotWorldThreadProcessor::ProcessBatch()
+PlayerbotWorldThreadProcessor::PriorityLevel PlayerbotWorldThreadProcessor::GetPriorityLevel(uint32 priority)
 {
-    // Extract a batch of operations from the queue
-    std::vector<std::unique_ptr<PlayerbotOperation>> batch;
-    batch.reserve(m_batchSize);
+    if (priority >= 100)
+        return PRIORITY_LEVEL_CRITICAL;
 
+    if (priority >= 50)
+        return PRIORITY_LEVEL_HIGH;
+
+    if (priority >= 10)
+        return PRIORITY_LEVEL_NORMAL;
+
+    return PRIORITY_LEVEL_LOW;
+}
+
+void PlayerbotWorldThreadProcessor::DrainIngress()
+{
+    IngressNode* node = m_ingress.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack is newest first, reverse it to submission order
+    IngressNode* ordered = nullptr;
+    while (node)
     {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
+        IngressNode* next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
 
-        // Extract up to batchSize operations
-        while (!m_operationQueue.empty() && batch.size() < m_batchSize)
+    uint32 coalesced = 0;
+    while (ordered)
+    {
+        std::unique_ptr<PlayerbotOperation> operation = std::move(ordered->operation);
+        IngressNode* next = ordered->next;
+        delete ordered;
+        ordered = next;
+
+        PlayerbotOperation& op = *operation;
+        ObjectGuid const botGuid = op.GetBotGuid();
+        CoalesceKey const key(botGuid, std::type_index(typeid(op)));
+
+        if (op.CanCoalesce())
+        {
+            auto found = m_coalesceIndex.find(key);
+            if (found != m_coalesceIndex.end())
+            {
+                *found->second = std::move(operation);
+                m_queueSize.fetch_sub(1, std::memory_order_relaxed);
+                ++coalesced;
+                continue;
+            }
+        }
+
+        // A more urgent operation must not overtake an earlier one of the same bot, e.g. a login
+        // running before the group cleanup of the previous logout
+        PriorityLevel levelIndex = GetPriorityLevel(op.GetPriority());
+        if (!botGuid.IsEmpty())
         {
-            batch.push_back(std::move(m_operationQueue.front()));
-            m_operationQueue.pop();
+            auto inserted = m_botPending.emplace(botGuid, std::make_pair(levelIndex, 0));
+            std::pair<PriorityLevel, uint32>& botPending = inserted.first->second;
+            botPending.first = std::max(botPending.first, levelIndex);
+            ++botPending.second;
+            levelIndex = botPending.first;
         }
 
-        // Update current queue size stat
+        // deque references stay valid on push_back and pop_front
+        std::deque<std::unique_ptr<PlayerbotOperation>>& level = m_pending[levelIndex];
+        level.push_back(std::move(operation));
+
+        if (op.CanCoalesce())
+            m_coalesceIndex.emplace(key, &level.back());
+    }
+
+    if (coalesced)
+    {
         std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        m_stats.currentQueueSize = static_cast<uint32>(m_operationQueue.size());
+        m_stats.totalOperationsCoalesced += coalesced;
     }
+}
+
+void PlayerbotWorldThreadProcessor::ProcessBatch()
+{
+    DrainIngress();
 
-    // Execute operations outside of lock to avoid blocking queue
+    // Execute operations highest priority first until the budget is spent
+    uint32 const batchStart = getMSTime();
     uint32 totalExecutionTime = 0;
-    for (auto& operation : batch)
+    uint32 executed = 0;
+
+    for (uint32 levelIndex = 0; levelIndex < MAX_PRIORITY_LEVELS; ++levelIndex)
     {
-        if (!operation)
-            continue;
+        std::deque<std::unique_ptr<PlayerbotOperation>>& level = m_pending[levelIndex];
 
-        try
+        while (!level.empty())
         {
-            // Check if operation is still valid
-            if (!operation->IsValid())
-            {
-                LOG_DEBUG("playerbots", "Skipping invalid operation: {}", operation->GetName());
+            if (executed && GetMSTimeDiffToNow(batchStart) >= m_updateBudgetMs)
+                break;
 
-                std::lock_guard<std::mutex> statsLock(m_statsMutex);
-                m_stats.totalOperationsSkipped++;
-                continue;
+            std::unique_ptr<PlayerbotOperation> operation = std::move(level.front());
+            level.pop_front();
+            m_queueSize.fetch_sub(1, std::memory_order_relaxed);
+
+            ObjectGuid const botGuid = operation->GetBotGuid();
+            if (operation->CanCoalesce())
+                m_coalesceIndex.erase(CoalesceKey(botGuid, std::type_index(typeid(*operation))));
+
+            if (!botGuid.IsEmpty())
+            {
+                auto botPending = m_botPending.find(botGuid);
+                if (botPending != m_botPending.end() && !--botPending->second.second)
+                    m_botPending.erase(botPending);
             }
 
-            // Time the execution
-            uint32 startTime = getMSTime();
+            ++executed;
+
+            try
+            {
+                // Check if operation is still valid
+                if (!operation->IsValid())
+                {
+                    LOG_DEBUG("playerbots", "Skipping invalid operation: {}", operation->GetName());
+
+                    std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                    m_stats.totalOperationsSkipped++;
+                    continue;
+                }
 
-            // Execute the operation
-            bool success = operation->Execute();
+                // Time the execution
+                uint32 startTime = getMSTime();
 
-            uint32 executionTime = GetMSTimeDiffToNow(startTime);
-            totalExecutionTime += executionTime;
+                // Execute the operation
+                bool success = operation->Execute();
 
-            // Log slow operations
-            if (executionTime > 100)
-                LOG_WARN("playerbots", "Slow operation: {} took {}ms", operation->GetName(), executionTime);
+                uint32 executionTime = GetMSTimeDiffToNow(startTime);
+                totalExecutionTime += executionTime;
 
-            // Update statistics
-            std::lock_guard<std::mutex> statsLock(m_statsMutex);
-            if (success)
-                m_stats.totalOperationsProcessed++;
-            else
+                // Log slow operations
+                if (executionTime > 100)
+                    LOG_WARN("playerbots", "Slow operation: {} took {}ms", operation->GetName(), executionTime);
+
+                // Update statistics
+                std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                if (success)
+                    m_stats.totalOperationsProcessed++;
+                else
+                {
+                    m_stats.totalOperationsFailed++;
+                    LOG_DEBUG("playerbots", "Operation failed: {}", operation->GetName());
+                }
+            }
+            catch (std::exception const& e)
             {
+                LOG_ERROR("playerbots", "Exception in operation {}: {}", operation->GetName(), e.what());
+
+                std::lock_guard<std::mutex> statsLock(m_statsMutex);
                 m_stats.totalOperationsFailed++;
-                LOG_DEBUG("playerbots", "Operation failed: {}", operation->GetName());
             }
-        }
-        catch (std::exception const& e)
-        {
-            LOG_ERROR("playerbots", "Exception in operation {}: {}", operation->GetName(), e.what());
+            catch (...)
+            {
+                LOG_ERROR("playerbots", "Unknown exception in operation {}", operation->GetName());
 
-            std::lock_guard<std::mutex> statsLock(m_statsMutex);
-            m_stats.totalOperationsFailed++;
+                std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                m_stats.totalOperationsFailed++;
+            }
         }
-        catch (...)
-        {
-            LOG_ERROR("playerbots", "Unknown exception in operation {}", operation->GetName());
 
-            std::lock_guard<std::mutex> statsLock(m_statsMutex);
-            m_stats.totalOperationsFailed++;
-        }
+        if (!level.empty())
+            break;
     }
 
     // Update average execution time
-    if (!batch.empty())
+    if (executed)
     {
         std::lock_guard<std::mutex> statsLock(m_statsMutex);
-        uint32 avgTime = totalExecutionTime / static_cast<uint32>(batch.size());
+        uint32 avgTime = totalExecutionTime / executed;
         // Exponential moving average
         m_stats.averageExecutionTimeMs =
             (m_stats.averageExecutionTimeMs * 9 + avgTime) / 10;  // 90% old, 10% new
@@ -165,38 +258,51 @@ void PlayerbotWorldThreadProcessor::CheckQueueHealth()
     {
         LOG_WARN("playerbots",
                  "PlayerbotWorldThreadProcessor queue is {}% full ({}/{}). "
-                 "Consider increasing update frequency or batch size.",
+                 "Consider increasing update frequency or time budget.",
                  (queueSize * 100) / m_maxQueueSize, queueSize, m_maxQueueSize);
     }
 }
 
 uint32 PlayerbotWorldThreadProcessor::GetQueueSize() const
 {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
-    return static_cast<uint32>(m_operationQueue.size());
+    return m_queueSize.load(std::memory_order_relaxed);
 }
 
 void PlayerbotWorldThreadProcessor::ClearQueue()
 {
-    std::lock_guard<std::mutex> lock(m_queueMutex);
+    // Take the ingress first, operations queued concurrently with clearing are kept
+    IngressNode* node = m_ingress.exchange(nullptr, std::memory_order_acquire);
 
-    uint32 cleared = static_cast<uint32>(m_operationQueue.size());
-    if (cleared > 0)
-        LOG_INFO("playerbots", "Clearing {} queued operations", cleared);
+    uint32 cleared = 0;
+    while (node)
+    {
+        IngressNode* next = node->next;
+        delete node;
+        node = next;
+        ++cleared;
+    }
 
-    // Clear the queue
-    while (!m_operationQueue.empty())
+    for (std::deque<std::unique_ptr<PlayerbotOperation>>& level : m_pending)
     {
-        m_operationQueue.pop();
+        cleared += static_cast<uint32>(level.size());
+        level.clear();
     }
 
-    // Reset queue size stat
-    std::lock_guard<std::mutex> statsLock(m_statsMutex);
-    m_stats.currentQueueSize = 0;
+    m_coalesceIndex.clear();
+    m_botPending.clear();
+    m_queueSize.fetch_sub(cleared, std::memory_order_relaxed);
+
+    if (cleared > 0)
+        LOG_INFO("playerbots", "Clearing {} queued operations", cleared);
 }
 
 PlayerbotWorldThreadProcessor::Statistics PlayerbotWorldThreadProcessor::GetStatistics() const
 {
     std::lock_guard<std::mutex> statsLock(m_statsMutex);
-    return m_stats;  // Return a copy
+
+    Statistics stats = m_stats;  // Return a copy
+    stats.totalOperationsSkipped += m_droppedOperations.load(std::memory_order_relaxed);
+    stats.currentQueueSize = m_queueSize.load(std::memory_order_relaxed);
+    stats.maxQueueSize = m_maxQueueSizeSeen.load(std::memory_order_relaxed);
+    return stats;
 }
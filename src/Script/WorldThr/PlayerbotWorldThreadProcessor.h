@@ -6,9 +6,13 @@
 #ifndef _PLAYERBOT_WORLD_THREAD_PROCESSOR_H
 #define _PLAYERBOT_WORLD_THREAD_PROCESSOR_H
 
+#include <atomic>
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <typeindex>
+#include <utility>
 
 #include "Log.h"
 #include "PlayerbotOperation.h"
@@ -21,10 +25,13 @@
  * like group modifications, LFG, guilds, battlegrounds, etc.
  *
  * Architecture:
- * - Map threads queue operations via QueueOperation()
+ * - Map threads queue operations via QueueOperation() onto a lock-free ingress stack, so they never block
  * - World thread processes operations via Update() (called from WorldScript::OnUpdate)
- * - Operations are processed in priority order
- * - Thread-safe queue protected by mutex
+ * - Update() moves the ingress into one FIFO per priority level (critical, high, normal, low), merging
+ *   operations that opt in to coalescing with the queued operation of the same type for the same bot
+ * - Operations of one bot run in submission order, one is queued at the level of an earlier pending
+ *   operation of its bot when that level is lower
+ * - Operations are processed in priority order until the per-update time budget is spent
  *
  * Usage:
  *   auto op = std::make_unique<MyOperation>(botGuid, params);
@@ -44,7 +51,7 @@ public:
      * @brief Update and process queued operations (called from world thread)
      *
      * This method should be called from WorldScript::OnUpdate hook, which runs in the world thread.
-     * It processes a batch of queued operations.
+     * It processes queued operations, highest priority first, for at most m_updateBudgetMs.
      *
      * @param diff Time since last update in milliseconds
      */
@@ -53,7 +60,7 @@ public:
     /**
      * @brief Queue an operation for execution in the world thread
      *
-     * Thread-safe method that can be called from any thread (typically map threads).
+     * Thread-safe and lock-free, can be called from any thread (typically map threads).
      * The operation will be executed later during Update().
      *
      * @param operation Unique pointer to the operation (ownership is transferred)
@@ -85,6 +92,7 @@ public:
         uint64 totalOperationsProcessed = 0;
         uint64 totalOperationsFailed = 0;
         uint64 totalOperationsSkipped = 0;
+        uint64 totalOperationsCoalesced = 0;
         uint32 currentQueueSize = 0;
         uint32 maxQueueSize = 0;
         uint32 averageExecutionTimeMs = 0;
@@ -108,7 +116,7 @@ private:
     PlayerbotWorldThreadProcessor()
     : m_enabled(true),
     m_maxQueueSize(10000),
-    m_batchSize(100),
+    m_updateBudgetMs(5),
     m_queueWarningThreshold(80),
     m_timeSinceLastUpdate(0),
     m_updateInterval(50)  // Process at least every 50ms
@@ -120,11 +128,38 @@ private:
         this->ClearQueue();
     }
 
+    enum PriorityLevel
+    {
+        PRIORITY_LEVEL_CRITICAL,  // priority >= 100
+        PRIORITY_LEVEL_HIGH,      // priority >= 50
+        PRIORITY_LEVEL_NORMAL,    // priority >= 10
+        PRIORITY_LEVEL_LOW,
+        MAX_PRIORITY_LEVELS
+    };
+
+    struct IngressNode
+    {
+        std::unique_ptr<PlayerbotOperation> operation;
+        IngressNode* next;
+    };
+
+    // Bot and dynamic operation type of a coalescable operation
+    typedef std::pair<ObjectGuid, std::type_index> CoalesceKey;
+
+    static PriorityLevel GetPriorityLevel(uint32 priority);
+
+    /**
+     * @brief Move operations from the ingress stack into the priority levels (world thread)
+     *
+     * Keeps submission order within a level and per bot. A coalescable operation replaces the queued one
+     * with the same key in place, so the newest parameters run at the oldest position.
+     */
+    void DrainIngress();
+
     /**
-     * @brief Process a single batch of operations
+     * @brief Process queued operations until the time budget is spent
      *
-     * Extracts operations from queue and executes them.
-     * Called internally by Update().
+     * At least one operation is executed per call. Called internally by Update().
      */
     void ProcessBatch();
 
@@ -135,14 +170,22 @@ private:
      */
     void CheckQueueHealth();
 
-    // Thread-safe queue
-    mutable std::mutex m_queueMutex;
-    std::queue<std::unique_ptr<PlayerbotOperation>> m_operationQueue;
+    // Lock-free ingress: producers push with a CAS, the world thread takes the whole stack at once
+    std::atomic<IngressNode*> m_ingress{nullptr};
+    std::atomic<uint32> m_queueSize{0};  // ingress + pending
+    std::atomic<uint32> m_maxQueueSizeSeen{0};
+    std::atomic<uint64> m_droppedOperations{0};
+
+    // Pending operations, world thread only
+    std::deque<std::unique_ptr<PlayerbotOperation>> m_pending[MAX_PRIORITY_LEVELS];
+    std::map<CoalesceKey, std::unique_ptr<PlayerbotOperation>*> m_coalesceIndex;
+    // bot -> lowest priority level holding pending operations of the bot, and their count
+    std::map<ObjectGuid, std::pair<PriorityLevel, uint32>> m_botPending;
 
     // Configuration
     bool m_enabled;
     uint32 m_maxQueueSize;           // Maximum operations in queue
-    uint32 m_batchSize;              // Operations to process per Update()
+    uint32 m_updateBudgetMs;         // Time budget per Update()
     uint32 m_queueWarningThreshold;  // Warn when queue reaches this percentage
 
     // Statistics
@@ -8,44 +8,82 @@
 #include "Log.h"
 #include "PlayerbotAIConfig.h"
 
-void Queue::Push(ActionBasket* action)
+Queue::~Queue()
+{
+    for (Entry const& entry : heap)
+    {
+        delete entry.basket;
+    }
+
+    for (ActionBasket* basket : freeBaskets)
+    {
+        delete basket;
+    }
+}
+
+void Queue::Push(ActionNode* action, float relevance, bool skipPrerequisites, Event const& event)
 {
     if (!action)
     {
         return;
     }
 
-    for (ActionBasket* basket : actions)
+    // The name is owned by the plan node, which outlives its basket in the queue
+    NameKey const name = {&action->getName(), action->getNameHash()};
+
+    auto found = index.find(name);
+    if (found != index.end())
     {
-        if (action->getAction()->getName() == basket->getAction()->getName())
+        size_t pos = found->second;
+        ActionBasket* existing = heap[pos].basket;
+        if (existing->getRelevance() < relevance)
         {
-            updateExistingBasket(basket, action);
-            return;
+            existing->setRelevance(relevance);
+            siftUp(pos);
         }
+
+        return;
+    }
+
+    ActionBasket* basket = nullptr;
+    if (freeBaskets.empty())
+    {
+        basket = new ActionBasket(action, relevance, skipPrerequisites, event);
+        ++allocations;
+    }
+    else
+    {
+        basket = freeBaskets.back();
+        freeBaskets.pop_back();
+        *basket = ActionBasket(action, relevance, skipPrerequisites, event);
     }
 
-    actions.push_back(action);
+    size_t* slot = &index.emplace(name, heap.size()).first->second;
+    heap.push_back({basket, pushSequence++, slot});
+    siftUp(heap.size() - 1);
 }
 
 ActionNode* Queue::Pop()
 {
-    ActionBasket* highestRelevanceBasket = findHighestRelevanceBasket();
-    if (!highestRelevanceBasket)
+    if (heap.empty())
     {
         return nullptr;
     }
 
-    return extractAndDeleteBasket(highestRelevanceBasket);
+    ActionBasket* basket = removeAt(0);
+    ActionNode* action = basket->getAction();
+    release(basket);
+    return action;
 }
 
 ActionBasket* Queue::Peek()
 {
-    return findHighestRelevanceBasket();
+    return heap.empty() ? nullptr : heap.front().basket;
 }
 
 uint32 Queue::Size()
 {
-    return actions.size();
+    return heap.size();
 }
 
 void Queue::RemoveExpired()
@@ -55,85 +93,119 @@ void Queue::RemoveExpired()
         return;
     }
 
-    std::list<ActionBasket*> expiredBaskets;
-    collectExpiredBaskets(expiredBaskets);
-    removeAndDeleteBaskets(expiredBaskets);
-}
+    uint32 expiryTime = sPlayerbotAIConfig.expireActionTime;
 
-// Private helper methods
-void Queue::updateExistingBasket(ActionBasket* existing, ActionBasket* newBasket)
-{
-    if (existing->getRelevance() < newBasket->getRelevance())
+    std::vector<size_t*> expiredSlots;
+    for (Entry const& entry : heap)
     {
-        existing->setRelevance(newBasket->getRelevance());
+        if (entry.basket->isExpired(expiryTime))
+        {
+            expiredSlots.push_back(entry.slot);
+        }
     }
 
-    if (ActionNode* actionNode = newBasket->getAction())
+    for (size_t* slot : expiredSlots)
     {
-        delete actionNode;
+        release(removeAt(*slot));
     }
+}
 
-    delete newBasket;
+uint32 Queue::TakeAllocations()
+{
+    uint32 result = allocations;
+    allocations = 0;
+    return result;
 }
 
-ActionBasket* Queue::findHighestRelevanceBasket() const
+// Private helper methods
+void Queue::release(ActionBasket* basket)
 {
-    if (actions.empty())
-    {
-        return nullptr;
-    }
+    *basket = ActionBasket(nullptr, 0.0f, false, Event());
+    freeBaskets.push_back(basket);
+}
 
-    float maxRelevance = -1.0f;
-    ActionBasket* selection = nullptr;
+ActionBasket* Queue::removeAt(size_t pos)
+{
+    ActionBasket* basket = heap[pos].basket;
 
-    for (ActionBasket* basket : actions)
-    {
-        if (!basket)
-        {
-            continue;
-        }
+    Entry last = heap.back();
+    heap.pop_back();
 
-        if (basket->getRelevance() > maxRelevance)
-        {
-            maxRelevance = basket->getRelevance();
-            selection = basket;
-        }
+    if (pos < heap.size())
+    {
+        place(pos, last);
+        siftDown(pos);
+        siftUp(pos);
     }
 
-    return selection;
+    ActionNode* action = basket->getAction();
+    index.erase(NameKey{&action->getName(), action->getNameHash()});
+    return basket;
 }
 
-ActionNode* Queue::extractAndDeleteBasket(ActionBasket* basket)
+bool Queue::higher(Entry const& a, Entry const& b) const
 {
-    ActionNode* action = basket->getAction();
-    actions.remove(basket);
-    delete basket;
-    return action;
+    float relevanceA = a.basket->getRelevance();
+    float relevanceB = b.basket->getRelevance();
+
+    if (relevanceA != relevanceB)
+    {
+        return relevanceA > relevanceB;
+    }
+
+    return a.sequence < b.sequence;
 }
 
-void Queue::collectExpiredBaskets(std::list<ActionBasket*>& expiredBaskets)
+void Queue::siftUp(size_t pos)
 {
-    uint32 expiryTime = sPlayerbotAIConfig.expireActionTime;
-    for (ActionBasket* basket : actions)
+    Entry entry = heap[pos];
+    while (pos > 0)
     {
-        if (basket->isExpired(expiryTime))
+        size_t parent = (pos - 1) / 2;
+        if (!higher(entry, heap[parent]))
         {
-            expiredBaskets.push_back(basket);
+            break;
         }
+
+        place(pos, heap[parent]);
+        pos = parent;
     }
+
+    place(pos, entry);
 }
 
-void Queue::removeAndDeleteBaskets(std::list<ActionBasket*>& basketsToRemove)
+void Queue::siftDown(size_t pos)
 {
-    for (ActionBasket* basket : basketsToRemove)
+    size_t size = heap.size();
+    Entry entry = heap[pos];
+
+    while (true)
     {
-        actions.remove(basket);
+        size_t child = pos * 2 + 1;
+        if (child >= size)
+        {
+            break;
+        }
 
-        if (ActionNode* action = basket->getAction())
+        if (child + 1 < size && higher(heap[child + 1], heap[child]))
         {
-            delete action;
+            ++child;
         }
 
-        delete basket;
+        if (!higher(heap[child], entry))
+        {
+            break;
+        }
+
+        place(pos, heap[child]);
+        pos = child;
     }
+
+    place(pos, entry);
+}
+
+void Queue::place(size_t pos, Entry const& entry)
+{
+    heap[pos] = entry;
+    *entry.slot = pos;
 }
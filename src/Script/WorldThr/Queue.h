@@ -6,6 +6,9 @@
 #ifndef PLAYERBOT_QUEUE_H
 #define PLAYERBOT_QUEUE_H
 
+#include <unordered_map>
+#include <vector>
+
 #include "Action.h"
 #include "Common.h"
 
@@ -13,31 +16,36 @@
  * @class Queue
  * @brief Manages a priority queue of actions for the playerbot system
  *
- * This queue maintains a list of ActionBasket objects, each containing an action
- * and its relevance score. Actions with higher relevance scores are prioritized.
+ * This queue maintains an indexed binary max-heap of ActionBasket objects, keyed by
+ * relevance score. Actions with higher relevance scores are prioritized; among equal
+ * relevance the earliest pushed action wins. A name index maps every queued action to
+ * its heap slot so duplicate pushes are merged without scanning the queue.
+ *
+ * The queue owns its baskets but not their ActionNodes, which belong to the engine's
+ * action plan. Released baskets are kept on a free list and reused, so a bot's steady
+ * state queue does no heap allocation.
  */
 class Queue
 {
 public:
     Queue() = default;
-    ~Queue() = default;
+    ~Queue();
 
     /**
      * @brief Adds an action to the queue or updates existing action's relevance
-     * @param action Pointer to the ActionBasket to be added
+     * @param action The plan node of the action to be added
      *
      * If an action with the same name exists, updates its relevance if the new
-     * relevance is higher, then deletes the new action. Otherwise, adds the new
-     * action to the queue.
+     * relevance is higher. Otherwise, adds a basket for the action to the queue,
+     * reusing a released one when available. O(log n).
      */
-    void Push(ActionBasket* action);
+    void Push(ActionNode* action, float relevance, bool skipPrerequisites, Event const& event);
 
     /**
      * @brief Removes and returns the action with highest relevance
      * @return Pointer to the highest relevance ActionNode, or nullptr if queue is empty
      *
-     * Ownership of the returned ActionNode is transferred to the caller.
-     * The associated ActionBasket is deleted.
+     * The associated ActionBasket is released to the free list for reuse. O(log n).
      */
     ActionNode* Pop();
 
@@ -57,38 +65,68 @@ public:
      * @brief Removes and deletes expired actions from the queue
      *
      * Uses sPlayerbotAIConfig.expireActionTime to determine if actions have expired.
-     * Both the ActionNode and ActionBasket are deleted for expired actions.
+     * The ActionBasket is deleted for expired actions; each removal is O(log n).
      */
     void RemoveExpired();
 
+    /**
+     * @brief Returns the number of baskets allocated from the heap since the last call
+     */
+    uint32 TakeAllocations();
+
 private:
     /**
-     * @brief Updates existing basket with new relevance and cleans up new basket
+     * @brief Index key: the name of a queued action, owned by its ActionNode, and the hash stored with it
      */
-    void updateExistingBasket(ActionBasket* existing, ActionBasket* newBasket);
+    struct NameKey
+    {
+        std::string const* name;
+        size_t hash;
+
+        bool operator==(NameKey const& other) const { return hash == other.hash && *name == *other.name; }
+    };
+
+    struct NameKeyHash
+    {
+        size_t operator()(NameKey const& key) const { return key.hash; }
+    };
 
     /**
-     * @brief Finds the basket with the highest relevance score
-     * @return Pointer to the highest relevance basket, or nullptr if queue is empty
+     * @brief Heap slot: the basket, its push sequence used to break relevance ties and
+     * the slot stored in the name index (node addresses are stable across rehashing)
      */
-    ActionBasket* findHighestRelevanceBasket() const;
+    struct Entry
+    {
+        ActionBasket* basket;
+        uint64 sequence;
+        size_t* slot;
+    };
 
     /**
-     * @brief Extracts action from basket and handles basket cleanup
+     * @brief Returns a basket to the free list, dropping its event payload
      */
-    ActionNode* extractAndDeleteBasket(ActionBasket* basket);
+    void release(ActionBasket* basket);
 
     /**
-     * @brief Collects all expired baskets into the provided list
+     * @brief Detaches the entry at the given heap slot and restores the heap invariant
+     * @return The detached basket (still owned by the caller)
      */
-    void collectExpiredBaskets(std::list<ActionBasket*>& expiredBaskets);
+    ActionBasket* removeAt(size_t pos);
 
     /**
-     * @brief Removes and deletes all baskets in the provided list
+     * @brief Strict heap ordering: higher relevance first, then lower push sequence
      */
-    void removeAndDeleteBaskets(std::list<ActionBasket*>& basketsToRemove);
+    bool higher(Entry const& a, Entry const& b) const;
+
+    void siftUp(size_t pos);
+    void siftDown(size_t pos);
+    void place(size_t pos, Entry const& entry);
 
-    std::list<ActionBasket*> actions; /**< Container for action baskets */
+    std::vector<Entry> heap;                                     /**< Binary max-heap of action baskets */
+    std::unordered_map<NameKey, size_t, NameKeyHash> index;      /**< Action name -> heap slot */
+    uint64 pushSequence = 0;                                     /**< Monotonic counter for FIFO tie-breaking */
+    std::vector<ActionBasket*> freeBaskets;                      /**< Released baskets ready for reuse */
+    uint32 allocations = 0;                                      /**< Heap allocated baskets since TakeAllocations */
 };
 
 #endif
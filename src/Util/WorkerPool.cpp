@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void WorkerPool::Run(uint32 count, std::function<void(uint32)> const& task)
+{
+    Job job;
+    job.task = &task;
+    job.count = count;
+
+    uint32 const helpers = count ? count - 1 : 0;
+    if (helpers)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        while (workers.size() < helpers)
+            workers.emplace_back(&WorkerPool::Work, this);
+
+        jobs.insert(jobs.end(), helpers, &job);
+    }
+
+    if (helpers == 1)
+        wake.notify_one();
+    else if (helpers)
+        wake.notify_all();
+
+    RunParts(job);
+
+    if (!helpers)
+        return;
+
+    // Every part has been taken, withdraw the entries no worker picked up and wait for those still inside
+    std::unique_lock<std::mutex> guard(lock);
+    jobs.erase(std::remove(jobs.begin(), jobs.end(), &job), jobs.end());
+    finished.wait(guard, [&job]() { return !job.helpers; });
+}
+
+void WorkerPool::RunParts(Job& job)
+{
+    for (uint32 part = job.next++; part < job.count; part = job.next++)
+        (*job.task)(part);
+}
+
+void WorkerPool::Work()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (true)
+    {
+        wake.wait(guard, [this]() { return stopping || !jobs.empty(); });
+        if (stopping)
+            return;
+
+        Job* job = jobs.front();
+        jobs.pop_front();
+        ++job->helpers;
+
+        guard.unlock();
+        RunParts(*job);
+        guard.lock();
+
+        if (!--job->helpers)
+            finished.notify_all();
+    }
+}
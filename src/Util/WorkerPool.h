@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016+ AzerothCore <www.azerothcore.org>, released under GNU AGPL v3 license, you may redistribute it
+ * and/or modify it under version 3 of the License, or (at your option), any later version.
+ */
+
+#ifndef _PLAYERBOT_WORKERPOOL_H
+#define _PLAYERBOT_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Define.h"
+
+/**
+ * @brief Persistent worker threads sharing short parallel loops of the map threads
+ *
+ * Run splits a loop into parts run by the calling thread and the idle workers. The caller works on its own
+ * parts too, so a loop completes even when every worker is busy with the loops of other map threads. Workers
+ * are started on first use and kept for the lifetime of the server.
+ */
+class WorkerPool
+{
+public:
+    static WorkerPool& instance()
+    {
+        static WorkerPool instance;
+
+        return instance;
+    }
+
+    /**
+     * @brief Runs task(0) .. task(count - 1) in parallel and returns when all have finished
+     *
+     * Up to count - 1 workers help the calling thread, the pool grows to that size when needed.
+     */
+    void Run(uint32 count, std::function<void(uint32)> const& task);
+
+private:
+    struct Job
+    {
+        std::function<void(uint32)> const* task;
+        uint32 count;
+        std::atomic<uint32> next{0};
+        uint32 helpers = 0;  // workers inside the job, guarded by lock
+    };
+
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    WorkerPool(WorkerPool const&) = delete;
+    WorkerPool& operator=(WorkerPool const&) = delete;
+
+    static void RunParts(Job& job);
+    void Work();
+
+    std::mutex lock;
+    std::condition_variable wake;      // a job was queued or the pool stops
+    std::condition_variable finished;  // a worker left a job
+    std::deque<Job*> jobs;             // one entry per helper a job asked for
+    std::vector<std::thread> workers;
+    bool stopping = false;
+};
+
+#endif